@@ -3,6 +3,7 @@ CONFIG += ordered
 SUBDIRS += \
     Taranis \
     TaranisTest \
+    TaranisFuzz \
     Example
 
 OTHER_FILES += Readme.md
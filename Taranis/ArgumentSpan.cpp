@@ -0,0 +1,92 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ArgumentSpan.hpp"
+
+using namespace Taranis;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan::ArgumentSpan() :
+    m_begin( 0 ),
+    m_count( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan::ArgumentSpan(const QStringList& inputs, int begin, int count) :
+    m_inputs( inputs ),
+    m_begin( begin ),
+    m_count( count )
+{
+    Q_ASSERT_X( ( begin >= 0 ) && ( count >= 0 ) && ( begin + count <= inputs.count() ), "ArgumentSpan", "Span is out of range." );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ArgumentSpan::count() const
+{
+    return m_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ArgumentSpan::size() const
+{
+    return m_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentSpan::isEmpty() const
+{
+    return m_count == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const QString& ArgumentSpan::at(int index) const
+{
+    Q_ASSERT_X( ( index >= 0 ) && ( index < m_count ), "ArgumentSpan::at", "Index out of range." );
+    return m_inputs.at( m_begin + index );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const QString& ArgumentSpan::operator[](int index) const
+{
+    return at( index );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan::const_iterator ArgumentSpan::begin() const
+{
+    return m_inputs.constBegin() + m_begin;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan::const_iterator ArgumentSpan::end() const
+{
+    return m_inputs.constBegin() + m_begin + m_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ArgumentSpan::toStringList() const
+{
+    return m_inputs.mid( m_begin, m_count );
+}
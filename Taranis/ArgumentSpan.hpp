@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ARGUMENTSPAN_HPP
+#define ARGUMENTSPAN_HPP
+
+#include <QString>
+#include <QStringList>
+
+namespace Taranis
+{
+    /**
+     * @brief The ArgumentSpan class is a read only view over a range of the inputs given on the command line.
+     * Positional arguments are handed out as spans over the inputs the CommandLineInterface retained so no matter how
+     * many inputs there are none of them are copied. A span stays valid for as long as you hold onto it, even if the
+     * CommandLineInterface it came from is destroyed.
+     *
+     * @code{.cpp}
+     * for ( const QString& file : cli.positional("files") )
+     * {
+     *     compile( file );
+     * }
+     * @endcode
+     */
+    class ArgumentSpan
+    {
+    public:
+        typedef QStringList::const_iterator const_iterator;
+
+        ArgumentSpan();
+        ArgumentSpan(const QStringList& inputs, int begin, int count);
+
+        int count() const;
+        int size() const;
+        bool isEmpty() const;
+        const QString& at(int index) const;
+        const QString& operator[](int index) const;
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /**
+         * @brief toStringList copies the span into a list.
+         */
+        QStringList toStringList() const;
+
+    private:
+        QStringList m_inputs;
+        int m_begin;
+        int m_count;
+    };
+}
+
+#endif // ARGUMENTSPAN_HPP
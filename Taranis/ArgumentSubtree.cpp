@@ -0,0 +1,185 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ArgumentSubtree.hpp"
+#include "Argument.hpp"
+#include "ValueStore.hpp"
+
+using namespace Taranis;
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::const_iterator::const_iterator(const ArgumentSubtree* subtree, index_iterator position) :
+    m_subtree( subtree ),
+    m_position( position )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const QString& ArgumentSubtree::const_iterator::key() const
+{
+    return m_position.key();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ArgumentSubtree::const_iterator::name() const
+{
+    return m_position.key().mid( m_subtree->m_path.length() + 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ArgumentSubtree::const_iterator::value() const
+{
+    return m_subtree->read( m_position.value() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::const_iterator& ArgumentSubtree::const_iterator::operator++()
+{
+    ++m_position;
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentSubtree::const_iterator::operator==(const const_iterator& other) const
+{
+    return m_position == other.m_position;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentSubtree::const_iterator::operator!=(const const_iterator& other) const
+{
+    return m_position != other.m_position;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::ArgumentSubtree() :
+    m_begin( m_index.constEnd() ),
+    m_end( m_index.constEnd() ),
+    m_count( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::ArgumentSubtree(const QString& path, const QMap<QString, Argument*>& index, const QSharedPointer<ValueStore>& values,
+                                 const Reader& reader) :
+    m_path( path ),
+    m_index( index ),
+    m_count( 0 ),
+    m_values( values ),
+    m_reader( reader )
+{
+    // Every name under the path sorts between "path." and "path/" since '/' follows '.', the index is
+    // only ever read through const iterators so it is never detached from the interface's copy.
+    const QMap<QString, Argument*>& constIndex = m_index;
+    m_begin = constIndex.lowerBound( path + QChar('.') );
+    m_end = constIndex.lowerBound( path + QChar('/') );
+    for ( index_iterator it = m_begin; it != m_end; ++it )
+    {
+        ++m_count;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ArgumentSubtree::path() const
+{
+    return m_path;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ArgumentSubtree::count() const
+{
+    return m_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentSubtree::isEmpty() const
+{
+    return m_count == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ArgumentSubtree::fullKey(const QString& name) const
+{
+    return m_path + QChar('.') + name.toLower();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ArgumentSubtree::read(const Argument* arg) const
+{
+    return m_reader ? m_reader( arg ) : m_values->value( arg );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentSubtree::contains(const QString& name) const
+{
+    return !m_path.isEmpty() && m_index.contains( fullKey( name ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ArgumentSubtree::value(const QString& name) const
+{
+    if ( m_path.isEmpty() ) return QVariant();
+
+    Argument* arg = m_index.value( fullKey( name ), nullptr );
+    return ( arg == nullptr ) ? QVariant() : read( arg );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ArgumentSubtree::operator[](const QString& name) const
+{
+    return value( name );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree ArgumentSubtree::subtree(const QString& path) const
+{
+    if ( m_path.isEmpty() ) return ArgumentSubtree();
+    return ArgumentSubtree( fullKey( path ), m_index, m_values, m_reader );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ArgumentSubtree::names() const
+{
+    QStringList names;
+    names.reserve( m_count );
+    for ( const_iterator it = begin(); it != end(); ++it )
+    {
+        names.append( it.name() );
+    }
+    return names;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::const_iterator ArgumentSubtree::begin() const
+{
+    return const_iterator( this, m_begin );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree::const_iterator ArgumentSubtree::end() const
+{
+    return const_iterator( this, m_end );
+}
@@ -0,0 +1,141 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ARGUMENTSUBTREE_HPP
+#define ARGUMENTSUBTREE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QMap>
+#include <QSharedPointer>
+#include <functional>
+
+namespace Taranis
+{
+    class CommandLineInterface;
+
+    namespace Internal
+    {
+        class Argument;
+        class ValueStore;
+    }
+
+    /**
+     * @brief The ArgumentSubtree class is a read only view over the arguments under a dotted path, such as <i>db.primary</i>.
+     * The view is a range of the CommandLineInterface's own sorted index of argument names so making one doesn't copy any
+     * names or values, values are read from the interface when you ask for them. Names are relative to the path of the
+     * subtree so a subsystem can be handed its slice of the options without knowing where it was mounted. Values read
+     * through the subtree have their placeholders expanded the same as the interface's index operator.
+     *
+     * @code{.cpp}
+     * ArgumentSubtree primary = cli.subtree("db.primary");
+     * database.configure( primary["host"].toString(), primary["port"].toInt() );
+     * @endcode
+     */
+    class ArgumentSubtree
+    {
+        friend class CommandLineInterface;
+    public:
+        typedef QMap<QString, Internal::Argument*>::const_iterator index_iterator;
+        typedef std::function<QVariant(const Internal::Argument*)> Reader;
+
+        /**
+         * @brief The const_iterator class walks the arguments of the subtree in name order.
+         */
+        class const_iterator
+        {
+        public:
+            const_iterator(const ArgumentSubtree* subtree, index_iterator position);
+
+            /**
+             * @brief key is the full normalized name of the argument, such as db.primary.host
+             */
+            const QString& key() const;
+
+            /**
+             * @brief name is the name of the argument relative to the subtree, such as host
+             */
+            QString name() const;
+            QVariant value() const;
+
+            const_iterator& operator++();
+            bool operator==(const const_iterator& other) const;
+            bool operator!=(const const_iterator& other) const;
+
+        private:
+            const ArgumentSubtree* m_subtree;
+            index_iterator m_position;
+        };
+
+        ArgumentSubtree();
+
+        QString path() const;
+        int count() const;
+        bool isEmpty() const;
+
+        /**
+         * @brief contains tells if there is an argument with the given name under the subtree.
+         * @param name is the name relative to the subtree. This look up is case insensitive.
+         */
+        bool contains(const QString& name) const;
+
+        /**
+         * @brief value returns the value of an argument under the subtree.
+         * @param name is the name relative to the subtree, such as host for db.primary.host. This look up is case insensitive.
+         * @return Returns the value of the argument or an invalid QVariant if it is not under the subtree.
+         */
+        QVariant value(const QString& name) const;
+        QVariant operator[](const QString& name) const;
+
+        /**
+         * @brief subtree narrows the view to a path under this one.
+         * @param path is the path relative to this subtree, such as primary for a db subtree.
+         */
+        ArgumentSubtree subtree(const QString& path) const;
+
+        /**
+         * @brief names copies the relative names of the arguments into a list.
+         */
+        QStringList names() const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        QString m_path;
+        QMap<QString, Internal::Argument*> m_index;
+        index_iterator m_begin;
+        index_iterator m_end;
+        int m_count;
+        QSharedPointer<Internal::ValueStore> m_values;
+        Reader m_reader;
+
+        ArgumentSubtree(const QString& path, const QMap<QString, Internal::Argument*>& index, const QSharedPointer<Internal::ValueStore>& values,
+                        const Reader& reader);
+        QString fullKey(const QString& name) const;
+        QVariant read(const Internal::Argument* arg) const;
+    };
+}
+
+#endif // ARGUMENTSUBTREE_HPP
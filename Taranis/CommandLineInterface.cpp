@@ -23,11 +23,29 @@
  */
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QFile>
+#include <QDataStream>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QThreadPool>
 #include <functional>
 #include "CommandLineInterface.hpp"
 #include "InputArgument.hpp"
 #include "TaranisExceptions.hpp"
 #include "Argument.hpp"
+#include "ConfigurationFile.hpp"
+#include "ConfigurationWatcher.hpp"
+#include "ValueStore.hpp"
+#include "ActionScheduler.hpp"
+#include "AllocationCounter.hpp"
+#include "PhaseTimer.hpp"
+#include "SchemaCache.hpp"
+#include "NamespaceTrie.hpp"
+#include "ConstraintSet.hpp"
+#include "PresetTable.hpp"
+#include "Interpolator.hpp"
+#include "ValidationBatch.hpp"
 
 using namespace Taranis;
 using namespace Taranis::Exceptions;
@@ -36,13 +54,47 @@ using action_callback = std::function<void(QVariant)>;
 
 const QString CommandLineInterface::VERSIONARGUMENT = "version";
 const QString CommandLineInterface::HELPARGUMENT = "help";
+const QString CommandLineInterface::ENDOFOPTIONS = "--";
+const QString CommandLineInterface::STATISTICSARGUMENT = "taranis-stats";
+const QString CommandLineInterface::COMPLETEARGUMENT = "--__complete";
+const quint32 CommandLineInterface::SERIALIZEDMAGIC = 0x54524E56; // TRNV
+const quint32 CommandLineInterface::SERIALIZEDFORMATVERSION = 1;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterface::CommandLineInterface(const QString applicationName, QStringList arguments, QStringList acceptedArgumentPrefixes)
     : m_applicationName(applicationName),
       m_inputArguments( arguments ),
-      m_acceptedArgumentPrefixs( acceptedArgumentPrefixes )
+      m_acceptedArgumentPrefixs( acceptedArgumentPrefixes ),
+      m_values( new ValueStore() ),
+      m_watchConfigurationFiles( false ),
+      m_deferActions( false ),
+      m_actionThreadPool( nullptr ),
+      m_lazyParsing( false ),
+      m_processedState( new ProcessedState() ),
+      m_answeringVersion( false ),
+      m_completing( false ),
+      m_lock( new QMutex( QMutex::Recursive ) ),
+      m_namespaces( new NamespaceTrie() ),
+      m_constraints( new ConstraintSet() ),
+      m_presets( new PresetTable() ),
+      m_pendingNamespaces( 0 ),
+      m_constructionAllocations( AllocationCounter::allocations() ),
+      m_constructionBytes( AllocationCounter::bytes() ),
+      m_statisticsArgument( nullptr ),
+      m_commandDepth( 0 ),
+      m_uncacheableRegistrations( 0 )
 {
+    m_constructionClock.start();
+
+    // The shell asks for completions with the words typed so far, the last one being the word under the cursor.
+    // The ones before it are kept as the inputs so commands are selected the same as they would be when run.
+    if ( !m_inputArguments.isEmpty() && ( m_inputArguments.first() == COMPLETEARGUMENT ) )
+    {
+        m_completing = true;
+        m_completionPartial = ( m_inputArguments.count() > 1 ) ? m_inputArguments.last() : QString();
+        m_inputArguments = m_inputArguments.mid( 1, m_inputArguments.count() - 2 );
+    }
+
     addHelpArguments();
 }
 
@@ -54,195 +106,1183 @@ CommandLineInterface::~CommandLineInterface()
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QString CommandLineInterface::name() const
+QString CommandLineInterface::name() const
+{
+    return m_applicationName;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::version() const
+{
+    return m_version;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::description() const
+{
+    return m_description;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::command() const
+{
+    return m_selectedCommands.join( QStringLiteral(" ") );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList CommandLineInterface::arguments() const
+{
+    loadAllNamespaces();
+    return m_arguments.keys();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterface& CommandLineInterface::process()
+{
+    QList< QPair<Argument*, QVariant> > matches;
+    QList< QPair<Argument*, QVariant> > boundValues;
+    QSet<Argument*> providedArguments;
+    QVector< QPair<int, int> > positionalRuns;
+    ParseStatistics* statistics = m_statistics.data();
+    if ( ( statistics != nullptr ) && ( statistics->count( ParseStatistics::Registration ) == 0 ) )
+    {
+        PhaseTimer::record( statistics, ParseStatistics::Registration, 0, m_constructionAllocations, m_constructionBytes );
+    }
+
+    PhaseTimer tokenization( statistics, ParseStatistics::Tokenization );
+
+    // Positional inputs are only recorded as runs of indexes into the inputs so even a very long
+    // list of files costs nothing per input beyond the option check.
+    auto addPositionalRun = [&positionalRuns]( int index, int count ) {
+        if ( count <= 0 ) return;
+        if ( !positionalRuns.isEmpty() && ( positionalRuns.last().first + positionalRuns.last().second == index ) )
+        {
+            positionalRuns.last().second += count;
+        }
+        else
+        {
+            positionalRuns.append( qMakePair( index, count ) );
+        }
+    };
+
+    auto addInput = [&]( const InputArgument& input, Argument* arg ) {
+        providedArguments.insert( arg );
+
+        // Bound arguments are written straight into the callers storage, there is no callback
+        // to run but the write waits until the whole command line has passed its checks.
+        if ( arg->binding().isBound() )
+        {
+            boundValues.append( qMakePair( arg, input.value() ) );
+            return;
+        }
+
+        QVariant value = input.value();
+
+        switch ( arg->type() )
+        {
+        case ArgumentType::Boolean:
+            value = true;
+            break;
+        case ArgumentType::Action:
+            value = arg->value();
+            break;
+        default:
+            if ( arg->hasChoices() ) value = toChoiceOrdinal( arg, value.toString() );
+            if ( arg->isPayload() ) value = QVariant::fromValue( Payload( value.toString() ) );
+            break;
+        }
+
+        matches.append( qMakePair( arg, value ) );
+    };
+
+    int numOfArguments = m_inputArguments.count();
+    for( int i = 0; i < numOfArguments; ++i )
+    {
+        const QString& token = m_inputArguments.at(i);
+        if ( token == ENDOFOPTIONS )
+        {
+            addPositionalRun( i + 1, numOfArguments - i - 1 );
+            break;
+        }
+
+        if ( !isOption( token ) )
+        {
+            addPositionalRun( i, 1 );
+            continue;
+        }
+
+        InputArgument input = parseInputArgument(i);
+        if ( !input.isValid() ) continue;
+
+        QString key = normilizeKey( input.name() );
+        Argument* arg = nullptr;
+        {
+            PhaseTimer lookup( statistics, ParseStatistics::Lookup );
+            arg = findArgument( key );
+        }
+
+        if ( arg != nullptr )
+        {
+            if ( !m_deprecatedNames.isEmpty() ) reportDeprecatedName( key );
+            addInput( input, arg );
+        }
+        else if ( !m_presets->isEmpty() && !input.hasValue() )
+        {
+            // The preset was lexed when it was added, its inputs are spliced in as if they had been typed here.
+            foreach( const InputArgument& presetInput, m_presets->expansion( key ) )
+            {
+                QString presetKey = normilizeKey( presetInput.name() );
+                Argument* presetArg = findArgument( presetKey );
+                if ( presetArg == nullptr ) continue;
+
+                if ( !m_deprecatedNames.isEmpty() ) reportDeprecatedName( presetKey );
+                addInput( presetInput, presetArg );
+            }
+        }
+    }
+
+    assignPositionalArguments( positionalRuns );
+    tokenization.stop();
+
+    // Values from the configuration files and environment sit below the command line so
+    // they are applied first, letting the command line callbacks have the final say.
+    PhaseTimer configuration( statistics, ParseStatistics::Configuration );
+    QSharedPointer<ConfigurationWatcher> watcher;
+    QList< QPair<Argument*, QVariant> > layeredValues = collectLayeredValues( providedArguments, watcher );
+    configuration.stop();
+
+    // Every rule and validator is checked before anything is written so a command line which
+    // breaks them has no effect. A value from the configuration files or environment counts
+    // the same as one typed on the command line.
+    QSet<Argument*> presentArguments = providedArguments;
+    for ( auto layered : layeredValues )
+    {
+        presentArguments.insert( layered.first );
+    }
+    checkConstraints( presentArguments );
+    validateValues( boundValues + layeredValues + matches );
+
+    PhaseTimer callbacks( statistics, ParseStatistics::Callbacks );
+    ValueBatch batch( *m_values );
+    for ( auto bound : boundValues )
+    {
+        if ( bound.first->type() == ArgumentType::Boolean )
+        {
+            bound.first->binding().writeFlag();
+        }
+        else
+        {
+            bound.first->binding().writeText( bound.second.toString() );
+        }
+    }
+    for ( auto layered : layeredValues )
+    {
+        applyValue( layered.first, layered.second );
+    }
+    for ( auto match : matches )
+    {
+        applyValue( match.first, match.second );
+    }
+    batch.commit();
+
+    // Bound storage holds the text as it was given, placeholders in it can reference any of the values
+    // so they are expanded once everything is published. All of them are expanded before any is rewritten.
+    if ( !m_interpolator.isNull() )
+    {
+        QList< QPair<Argument*, QVariant> > expandedValues;
+        for ( auto bound : boundValues )
+        {
+            if ( ( bound.first->type() == ArgumentType::Boolean ) || !bound.second.toString().contains( QStringLiteral("${") ) ) continue;
+            expandedValues.append( qMakePair( bound.first, interpolatedValue( bound.first ) ) );
+        }
+        for ( auto expanded : expandedValues )
+        {
+            m_values->setValue( expanded.first, expanded.second );
+        }
+    }
+
+    if ( !watcher.isNull() ) m_processedState->configurationWatcher = watcher;
+
+    // Deferred actions only run once everything has been parsed and the values are published.
+    runPendingActions();
+    callbacks.stop();
+
+    writeStatistics( providedArguments.contains( m_statisticsArgument ) );
+    m_processedState->processed.storeRelease( 1 );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::requiresEagerProcessing() const
+{
+    if ( !m_configurationFiles.isEmpty() || !m_environmentPrefix.isEmpty() || !m_statistics.isNull() ) return true;
+
+    // A required argument can be missing from any command line, the rules are checked up front where the caller expects the exception.
+    if ( !m_constraints->isEmpty() ) return true;
+
+    foreach( const QString& token, m_inputArguments )
+    {
+        if ( token == ENDOFOPTIONS ) break;
+        if ( !isOption( token ) ) continue;
+
+        InputArgument input( token, m_acceptedArgumentPrefixs );
+        QString key = normilizeKey( input.name() );
+        Argument* arg = findArgument( key );
+        if ( ( arg != nullptr ) && ( arg->hasCallback() || arg->binding().isBound() ) ) return true;
+
+        // Same for a value which can be refused, it must not throw from the index operator later on.
+        if ( ( arg != nullptr ) && ( arg->hasChoices() || !arg->validators().isEmpty() ) ) return true;
+
+        // A preset can stand for any of those, it's processed up front rather than looking through it.
+        if ( ( arg == nullptr ) && m_presets->contains( key ) ) return true;
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::ensureProcessed() const
+{
+    if ( !m_lazyParsing || m_processedState->processed.loadAcquire() ) return;
+
+    QMutexLocker lock( m_lock.data() );
+    if ( m_processedState->processed.loadAcquire() ) return;
+
+    // Nothing which processing touches is visible to the caller until it is done, so doing it from a const
+    // accessor only changes when the work happens.
+    const_cast<CommandLineInterface*>( this )->process();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::writeStatistics(bool requested) const
+{
+    if ( m_statistics.isNull() ) return;
+
+    if ( requested )
+    {
+        fprintf( stderr, "%s\n", m_statistics->toJson().constData() );
+    }
+
+    if ( !m_traceFile.isEmpty() )
+    {
+        QFile trace( m_traceFile );
+        if ( trace.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+        {
+            trace.write( m_statistics->toChromeTrace() );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ParseStatistics CommandLineInterface::statistics() const
+{
+    return m_statistics.isNull() ? ParseStatistics( m_constructionClock ) : *m_statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::enableStatistics(const QString traceFile)
+{
+    m_traceFile = traceFile;
+    if ( !m_statistics.isNull() ) return;
+
+    m_statistics = QSharedPointer<ParseStatistics>( new ParseStatistics( m_constructionClock ) );
+
+    // Hidden and without a short name so it never collides with, or shows up next to, your own arguments.
+    m_statisticsArgument = new Argument( STATISTICSARGUMENT, "Print parse statistics as JSON", ArgumentType::Boolean, nullptr );
+    m_statisticsArgument->setHidden( true );
+    m_statisticsArgument->setShortNameEnabled( false );
+    addArgument( m_statisticsArgument );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::applyValue(Argument* arg, const QVariant& value)
+{
+    if ( m_deferActions && arg->hasCallback() && !isBuiltInAction( arg ) )
+    {
+        m_pendingActions.append( qMakePair( arg, value ) );
+    }
+    else
+    {
+        m_values->apply( arg, value );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::isBuiltInAction(const Argument* arg) const
+{
+    if ( arg->type() != ArgumentType::Action ) return false;
+
+    QString name = normilizeKey( arg->name() );
+    return ( name == HELPARGUMENT ) || ( name == QStringLiteral("?") ) || ( name == VERSIONARGUMENT );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int CommandLineInterface::toChoiceOrdinal(const Argument* arg, const QString& value) const
+{
+    int ordinal = arg->choices().ordinal( value );
+    if ( ordinal < 0 )
+    {
+        throw InvalidChoiceException( arg->name(), value, arg->choices().choices() );
+    }
+    return ordinal;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::validateValues(const QList< QPair<Argument*, QVariant> >& values) const
+{
+    QSharedPointer<ValidationBatch> batch( new ValidationBatch() );
+    for ( const auto& value : values )
+    {
+        batch->add( value.first, value.second.toString() );
+    }
+    if ( batch->isEmpty() ) return;
+
+    QStringList failures = batch->run( ( m_actionThreadPool != nullptr ) ? m_actionThreadPool : QThreadPool::globalInstance() );
+    if ( !failures.isEmpty() )
+    {
+        throw ValidationException( failures );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QRegularExpression CommandLineInterface::compiledPattern(const QString& pattern)
+{
+    auto it = m_patterns.constFind( pattern );
+    if ( it != m_patterns.constEnd() ) return it.value();
+
+    QRegularExpression expression( QString("\\A(?:%1)\\z").arg( pattern ) );
+    Q_ASSERT_X( expression.isValid(), "CommandLineInterface::compiledPattern", expression.errorString().toLatin1().data() );
+
+    // Copies share the compiled and JIT optimized pattern, so this is only ever done once per pattern.
+    expression.optimize();
+    m_patterns.insert( pattern, expression );
+    return expression;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::runPendingActions()
+{
+    if ( m_pendingActions.isEmpty() && ( m_actionThreadPool == nullptr ) ) return;
+
+    QSharedPointer<ActionScheduler> scheduler( new ActionScheduler( m_pendingActions, m_actionThreadPool ) );
+    m_pendingActions.clear();
+    m_processedState->actionsFinished = scheduler->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QFuture<void> CommandLineInterface::actionsFinished() const
+{
+    return m_processedState->actionsFinished;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList< QPair<Argument*, QVariant> > CommandLineInterface::collectLayeredValues(const QSet<Argument*>& providedArguments, QSharedPointer<ConfigurationWatcher>& watcher)
+{
+    QList< QPair<Argument*, QVariant> > layeredValues;
+    if ( m_configurationFiles.isEmpty() && m_environmentPrefix.isEmpty() ) return layeredValues;
+    loadAllNamespaces();
+
+    QMap<QString, Argument*> pendingArguments;
+    foreach( Argument* arg, m_arguments )
+    {
+        if ( ( arg->type() == ArgumentType::Action ) || providedArguments.contains( arg ) ) continue;
+        pendingArguments.insert( normilizeKey( arg->name() ), arg );
+    }
+
+    // When the command line covers everything there is no reason to touch the configuration files.
+    if ( pendingArguments.isEmpty() ) return layeredValues;
+
+    QHash<QString, QString> values;
+    QSet<QString> remainingKeys;
+    foreach( QString key, pendingArguments.keys() )
+    {
+        QByteArray variable = environmentVariableName( key );
+        if ( !variable.isEmpty() && qEnvironmentVariableIsSet( variable.constData() ) )
+        {
+            values[key] = QString::fromLocal8Bit( qgetenv( variable.constData() ) );
+        }
+        else
+        {
+            remainingKeys.insert( key );
+        }
+    }
+
+    QHash<QString, QString> fileValues = ConfigurationFile::read( m_configurationFiles, remainingKeys );
+    for ( auto it = fileValues.constBegin(); it != fileValues.constEnd(); ++it )
+    {
+        values[it.key()] = it.value();
+    }
+
+    for ( auto it = pendingArguments.constBegin(); it != pendingArguments.constEnd(); ++it )
+    {
+        if ( !values.contains( it.key() ) ) continue;
+
+        Argument* arg = it.value();
+        QString value = values[it.key()];
+
+        if ( arg->type() == ArgumentType::Boolean )
+        {
+            // Flags are only ever turned on, a false in the configuration leaves the default in place.
+            if ( !ConfigurationFile::toBool( value ) ) continue;
+            layeredValues.append( qMakePair( arg, QVariant( true ) ) );
+        }
+        else if ( arg->hasChoices() )
+        {
+            layeredValues.append( qMakePair( arg, QVariant( toChoiceOrdinal( arg, value ) ) ) );
+        }
+        else if ( arg->isPayload() )
+        {
+            layeredValues.append( qMakePair( arg, QVariant::fromValue( Payload( value ) ) ) );
+        }
+        else
+        {
+            layeredValues.append( qMakePair( arg, QVariant( value ) ) );
+        }
+    }
+
+    if ( m_watchConfigurationFiles && !m_configurationFiles.isEmpty() && !remainingKeys.isEmpty() )
+    {
+        QMap<QString, Argument*> watchedArguments;
+        foreach( QString key, remainingKeys )
+        {
+            watchedArguments[key] = pendingArguments[key];
+        }
+        watcher = QSharedPointer<ConfigurationWatcher>( new ConfigurationWatcher( m_configurationFiles, watchedArguments, fileValues, m_values ) );
+    }
+    return layeredValues;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QByteArray CommandLineInterface::environmentVariableName(const QString& key) const
+{
+    if ( m_environmentPrefix.isEmpty() ) return QByteArray();
+
+    QString name = QString("%1_%2").arg(m_environmentPrefix).arg(key).toUpper();
+    name.replace( QChar('-'), QChar('_') );
+    name.replace( QChar('.'), QChar('_') );
+    return name.toLocal8Bit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+InputArgument CommandLineInterface::parseInputArgument(int& index)
+{
+    int numOfArguments = m_inputArguments.count();
+    InputArgument input( m_inputArguments.at(index), m_acceptedArgumentPrefixs );
+
+    if ( ( numOfArguments > 1 ) && (index < numOfArguments - 1 ) && input.isValid() && !input.hasValue() )
+    {
+        // Only arguments which take a value may claim the next input, for flags and actions it is a positional input.
+        QString key = normilizeKey( input.name() );
+        Argument* arg = findArgument( key );
+        bool takesValue = ( arg == nullptr ) ? !m_presets->contains( key ) : ( arg->type() == ArgumentType::String );
+
+        const QString& nextArgument = m_inputArguments.at(index+1);
+        if ( takesValue && ( nextArgument != ENDOFOPTIONS ) && !isOption( nextArgument ) )
+        {
+            input.attachValue( nextArgument );
+            ++index;
+        }
+    }
+
+    return input;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::isOption(const QString& input) const
+{
+    // Mirrors InputArgument, the longest matching prefix must be followed by a name so a lone
+    // dash is a positional input, it commonly stands for stdin.
+    int prefixLength = -1;
+    foreach( const QString& prefix, m_acceptedArgumentPrefixs )
+    {
+        if ( ( prefix.length() > prefixLength ) && input.startsWith( prefix ) )
+        {
+            prefixLength = prefix.length();
+        }
+    }
+    return ( prefixLength >= 0 ) && ( input.length() > prefixLength );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int CommandLineInterface::firstPositionalIndex() const
+{
+    int numOfArguments = m_inputArguments.count();
+    for ( int i = 0; i < numOfArguments; ++i )
+    {
+        const QString& input = m_inputArguments.at(i);
+        if ( input == ENDOFOPTIONS ) return -1;
+        if ( !isOption( input ) ) return i;
+
+        // An option which is already known to take a value claims the next input the same as it will when
+        // processing, options added later can't be told apart from flags so they don't.
+        InputArgument option( input, m_acceptedArgumentPrefixs );
+        if ( option.hasValue() ) continue;
+        Argument* arg = findArgument( normilizeKey( option.name() ) );
+        if ( ( arg != nullptr ) && ( arg->type() == ArgumentType::String ) ) ++i;
+    }
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addCommand(const QString name, const QString description)
+{
+    ++m_uncacheableRegistrations;
+    m_commands[name] = description;
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::selectCommand(int index, const QString name)
+{
+    ++m_uncacheableRegistrations;
+    m_inputArguments.removeAt( index );
+    m_selectedCommands.append( name );
+
+    // Only the selected commands own subcommands are of interest from here on.
+    m_commands.clear();
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::normilizeKey(const QString &key) const
+{
+    // Lower case keys are handed back as they are. Mixed case ASCII keys are lowered into a buffer kept per thread
+    // so looking them up doesn't allocate every time, the result shares the buffer and anyone who holds on to it
+    // only makes the next call on the thread copy.
+    static thread_local QString buffer;
+
+    const int length = key.length();
+    const QChar* input = key.constData();
+    int first = 0;
+    while ( ( first < length ) && ( input[first].unicode() < 0x80 ) && !input[first].isUpper() ) ++first;
+    if ( first == length ) return key;
+
+    for ( int i = first; i < length; ++i )
+    {
+        if ( input[i].unicode() >= 0x80 ) return key.toLower();
+    }
+
+    buffer.resize( length );
+    QChar* output = buffer.data();
+    for ( int i = 0; i < length; ++i )
+    {
+        ushort c = input[i].unicode();
+        output[i] = QChar( ( ( c >= 'A' ) && ( c <= 'Z' ) ) ? ushort( c + ( 'a' - 'A' ) ) : c );
+    }
+    return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant CommandLineInterface::operator[](const QString key) const
+{
+    ensureProcessed();
+    QString normilizedKey = normilizeKey( key );
+    Argument* option = findArgument( normilizedKey );
+    if ( option != nullptr ) return interpolatedValue( option );
+
+    Argument* arg = findPositionalArgument( normilizedKey );
+    if ( arg == nullptr ) return QVariant();
+
+    ArgumentSpan inputs = positional( normilizedKey );
+    if ( arg->type() == ArgumentType::PositionalList ) return inputs.toStringList();
+    return inputs.isEmpty() ? QVariant() : QVariant( inputs.at(0) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant CommandLineInterface::interpolatedValue(const Argument* arg) const
+{
+    if ( m_interpolator.isNull() ) return m_values->value( arg );
+    return m_interpolator->value( arg, [this]( const QString& name ) { return findArgument( normilizeKey( name ) ); } );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan CommandLineInterface::positionalArguments() const
+{
+    ensureProcessed();
+    return ArgumentSpan( m_processedState->positionalInputs, m_processedState->positionalOffset, m_processedState->positionalCount );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSpan CommandLineInterface::positional(const QString name) const
+{
+    ensureProcessed();
+    QString normilizedKey = normilizeKey( name );
+    if ( !m_processedState->positionalRanges.contains( normilizedKey ) ) return ArgumentSpan();
+
+    QPair<int, int> range = m_processedState->positionalRanges[normilizedKey];
+    return ArgumentSpan( m_processedState->positionalInputs, m_processedState->positionalOffset + range.first, range.second );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentSubtree CommandLineInterface::subtree(const QString path) const
+{
+    ensureProcessed();
+    QString normilizedPath = normilizeKey( path );
+    if ( normilizedPath.isEmpty() ) return ArgumentSubtree();
+
+    if ( m_pendingNamespaces.loadAcquire() > 0 )
+    {
+        loadNamespaces( m_namespaces->findUnder( normilizedPath ) );
+    }
+
+    // The subtree keeps its own handle on this interface so placeholders still resolve after this copy is gone.
+    ArgumentSubtree::Reader reader;
+    if ( !m_interpolator.isNull() )
+    {
+        QSharedPointer<CommandLineInterface> cli( new CommandLineInterface( *this ) );
+        reader = [cli]( const Argument* arg ) { return cli->interpolatedValue( arg ); };
+    }
+
+    QMutexLocker lock( m_lock.data() );
+    return ArgumentSubtree( normilizedPath, m_arguments, m_values, reader );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder CommandLineInterface::build()
+{
+    return CommandLineInterfaceBuilder();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addArgument(Argument* arg)
+{
+    validateArgumentName(*arg);
+    m_arguments[normilizeKey( arg->name() )] = arg;
+
+    if ( arg->hasShortName() )
+    {
+        validateArgumentShortName(*arg);
+        m_arguments[normilizeKey( arg->shortName() )] = arg;
+    }
+
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addPositionalArgument(Argument* arg)
+{
+    QString normilizedName = normilizeKey( arg->name() );
+    if ( m_arguments.contains( normilizedName ) || ( findPositionalArgument( normilizedName ) != nullptr ) )
+    {
+        throw ArgumentRedefinitionException( arg->name() );
+    }
+
+    if ( arg->type() == ArgumentType::PositionalList )
+    {
+        foreach( Argument* existing, m_positionalArguments )
+        {
+            if ( existing->type() == ArgumentType::PositionalList ) throw PositionalListRedefinitionException( arg->name() );
+        }
+    }
+
+    m_positionalArguments.append( arg );
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+Argument* CommandLineInterface::findPositionalArgument(const QString& key) const
+{
+    foreach( Argument* arg, m_positionalArguments )
+    {
+        if ( normilizeKey( arg->name() ) == key ) return arg;
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::assignPositionalArguments(const QVector< QPair<int, int> >& runs)
+{
+    // A single run, such as everything after the end of options marker, is handed out as is. Otherwise
+    // the runs are compacted into a new list which only copies the implicitly shared string handles.
+    if ( runs.count() <= 1 )
+    {
+        m_processedState->positionalInputs = m_inputArguments;
+        m_processedState->positionalOffset = runs.isEmpty() ? 0 : runs.first().first;
+        m_processedState->positionalCount = runs.isEmpty() ? 0 : runs.first().second;
+    }
+    else
+    {
+        m_processedState->positionalInputs.clear();
+        m_processedState->positionalCount = 0;
+        for ( auto run : runs )
+        {
+            m_processedState->positionalCount += run.second;
+        }
+
+        m_processedState->positionalInputs.reserve( m_processedState->positionalCount );
+        for ( auto run : runs )
+        {
+            for ( int i = run.first; i < run.first + run.second; ++i )
+            {
+                m_processedState->positionalInputs.append( m_inputArguments.at(i) );
+            }
+        }
+        m_processedState->positionalOffset = 0;
+    }
+
+    // Single positionals take one input each, the positional list takes what is left over
+    // once the single positionals declared after it have had their share.
+    int remainingSingles = 0;
+    foreach( Argument* arg, m_positionalArguments )
+    {
+        if ( arg->type() == ArgumentType::Positional ) ++remainingSingles;
+    }
+
+    m_processedState->positionalRanges.clear();
+    int next = 0;
+    foreach( Argument* arg, m_positionalArguments )
+    {
+        QString key = normilizeKey( arg->name() );
+        if ( arg->type() == ArgumentType::PositionalList )
+        {
+            int count = qMax( 0, m_processedState->positionalCount - next - remainingSingles );
+            m_processedState->positionalRanges[key] = qMakePair( next, count );
+            next += count;
+        }
+        else
+        {
+            --remainingSingles;
+            if ( next < m_processedState->positionalCount )
+            {
+                m_processedState->positionalRanges[key] = qMakePair( next, 1 );
+                ++next;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::validateArgumentName(const Argument& arg) const
+{
+    QString normilizedName = normilizeKey( arg.name() );
+    if ( ( findPositionalArgument( normilizedName ) != nullptr ) || m_presets->contains( normilizedName ) )
+    {
+        throw ArgumentRedefinitionException( arg.name() );
+    }
+    if ( m_arguments.contains( normilizedName ) )
+    {
+        if ( normilizedName == VERSIONARGUMENT )
+        {
+            throw VersionArgumentRedefinitionException();
+        }
+        else if (( normilizedName == HELPARGUMENT ) || ( normilizedName == "?" ))
+        {
+            // Ok to overide
+            qWarning("The built in help argument is being overriden");
+        }
+        else
+        {
+            throw ArgumentRedefinitionException(arg.name());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::validateArgumentShortName(const Argument &arg) const
+{
+    QString normalizedName = normilizeKey( arg.name() );
+    if ( normalizedName == HELPARGUMENT ) return;
+
+    QString normilizedShortName = normilizeKey( arg.shortName() );
+    if ( m_arguments.contains( normilizedShortName ) )
+    {
+        if ( ( normilizedShortName == VERSIONARGUMENT.at(0) ) && m_arguments.contains(VERSIONARGUMENT) )
+        {
+            throw VersionShortNameCollisionException( arg.name() );
+        }
+        else if (( normilizedShortName == HELPARGUMENT.at(0) ) || ( normilizedShortName == "?" ))
+        {
+            throw HelpShortNameCollisionException( arg.name() );
+        }
+        else
+        {
+            throw ShortNameCollisionException(arg.name(), m_arguments[normilizedShortName]->name());
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setVersion(const QString version)
+{
+    Q_ASSERT_X( !version.isEmpty(), "CLI::setVersion", "Version should not be empty." );
+
+    m_version = version;
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setName(const QString name)
+{
+    m_applicationName = name;
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setDescription(const QString description)
+{
+    m_description = description;
+    m_renderedHelp.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addConfigurationFile(const QString path)
+{
+    m_configurationFiles.append( path );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setEnvironmentPrefix(const QString prefix)
+{
+    m_environmentPrefix = prefix;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setWatchConfigurationFiles(bool watch)
+{
+    m_watchConfigurationFiles = watch;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setDeferActions(bool defer)
+{
+    m_deferActions = defer;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setArgumentPriority(const QString key, int priority)
+{
+    QString normilizedKey = normilizeKey( key );
+    if ( m_arguments.contains(normilizedKey) )
+    {
+        m_arguments[normilizedKey]->setPriority( priority );
+    }
+    else
+    {
+        Q_ASSERT_X( false, "CommandLineInterface::setArgumentPriority", QString("No argument with name %1").arg(key).toLatin1().data() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setActionThreadPool(QThreadPool* pool)
+{
+    m_actionThreadPool = pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setLazyParsing(bool lazy)
+{
+    m_lazyParsing = lazy;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::setInterpolation(bool interpolate)
+{
+    m_interpolator = interpolate ? QSharedPointer<Interpolator>( new Interpolator( m_values ) ) : QSharedPointer<Interpolator>();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::isVersionOnlyRequest() const
+{
+    if ( m_completing ) return false;
+    if ( ( m_inputArguments.count() != 1 ) || !isOption( m_inputArguments.first() ) ) return false;
+
+    QString name = normilizeKey( InputArgument( m_inputArguments.first(), m_acceptedArgumentPrefixs ).name() );
+    return ( name == VERSIONARGUMENT ) || ( name == VERSIONARGUMENT.at(0) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::loadSchemaCache(const QString& path, const QByteArray& manifestHash)
+{
+    QList<Argument*> arguments;
+    QList< QPair<QString, Argument*> > lookup;
+    if ( !SchemaCache( path ).read( manifestHash, arguments, lookup ) ) return false;
+
+    // The cached arguments were validated against each other when the cache was written, they only
+    // need checking against what was registered around them which is what the manifest hash doesn't cover.
+    bool collides = false;
+    for ( auto entry : lookup )
+    {
+        collides = collides || m_arguments.contains( entry.first ) || ( findPositionalArgument( entry.first ) != nullptr );
+    }
+    foreach( Argument* arg, arguments )
+    {
+        bool positional = ( arg->type() == ArgumentType::Positional ) || ( arg->type() == ArgumentType::PositionalList );
+        collides = collides || ( positional && ( m_arguments.contains( normilizeKey( arg->name() ) ) || ( findPositionalArgument( normilizeKey( arg->name() ) ) != nullptr ) ) );
+    }
+
+    if ( collides )
+    {
+        qDeleteAll( arguments );
+        return false;
+    }
+
+    foreach( Argument* arg, arguments )
+    {
+        if ( ( arg->type() == ArgumentType::Positional ) || ( arg->type() == ArgumentType::PositionalList ) )
+        {
+            m_positionalArguments.append( arg );
+        }
+    }
+    for ( auto entry : lookup )
+    {
+        m_arguments.insert( entry.first, entry.second );
+    }
+
+    m_renderedHelp.clear();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::saveSchemaCache(const QString& path, const QByteArray& manifestHash, const QSet<Argument*>& existingArguments, int existingPositionalCount) const
 {
-    return m_applicationName;
+    QList<Argument*> arguments;
+    QList< QPair<QString, Argument*> > lookup;
+    QSet<Argument*> added;
+    for ( auto it = m_arguments.constBegin(); it != m_arguments.constEnd(); ++it )
+    {
+        Argument* arg = it.value();
+        if ( existingArguments.contains( arg ) ) continue;
+        if ( !SchemaCache::isCacheable( *arg ) ) return;
+
+        if ( !added.contains( arg ) )
+        {
+            added.insert( arg );
+            arguments.append( arg );
+        }
+        lookup.append( qMakePair( it.key(), arg ) );
+    }
+
+    for ( int i = existingPositionalCount; i < m_positionalArguments.count(); ++i )
+    {
+        arguments.append( m_positionalArguments.at(i) );
+    }
+
+    SchemaCache( path ).write( manifestHash, arguments, lookup );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QString CommandLineInterface::version() const
+void CommandLineInterface::addNamespace(const QString& path, std::function<void(CommandLineInterfaceBuilder&)> loader)
 {
-    return m_version;
+    ++m_uncacheableRegistrations;
+    m_namespaces->insert( normilizeKey( path ), loader );
+    m_pendingNamespaces.storeRelease( m_namespaces->count() - m_loadedNamespaces.count() );
+    m_renderedHelp.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QString CommandLineInterface::description() const
+Argument* CommandLineInterface::findArgument(const QString& normalizedKey) const
 {
-    return m_description;
+    // Once every namespace is loaded the arguments no longer change so there is no need to lock.
+    if ( m_pendingNamespaces.loadAcquire() == 0 ) return m_arguments.value( normalizedKey, nullptr );
+
+    QMutexLocker lock( m_lock.data() );
+    Argument* arg = m_arguments.value( normalizedKey, nullptr );
+    if ( arg == nullptr )
+    {
+        loadNamespaces( m_namespaces->find( normalizedKey ) );
+        arg = m_arguments.value( normalizedKey, nullptr );
+    }
+    return arg;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QStringList CommandLineInterface::arguments() const
+void CommandLineInterface::loadNamespaces(const QList<int>& namespaces) const
 {
-    return m_arguments.keys();
-}
+    if ( namespaces.isEmpty() ) return;
 
-////////////////////////////////////////////////////////////////////////////////////////////////
-CommandLineInterface& CommandLineInterface::process()
-{  
-    int numOfArguments = m_inputArguments.count();
-    for( int i = 0; i < numOfArguments; ++i )
+    // Registering is done on the interface the value was asked for, the same as lazy processing it
+    // doesn't change what the caller sees other than when the work happens.
+    QMutexLocker lock( m_lock.data() );
+    CommandLineInterface* self = const_cast<CommandLineInterface*>( this );
+    foreach( int id, namespaces )
     {
-        InputArgument* input = parseInputArgument(i);
+        if ( m_loadedNamespaces.contains( id ) ) continue;
 
-        if ( input->isValid() )
-        {
-            QString key = normilizeKey( input->name() );
-            if ( m_arguments.contains( key ) )
-            {
-                Argument* arg = m_arguments[key];
-                QVariant value = input->value();
-
-                switch ( arg->type() )
-                {
-                case ArgumentType::Boolean:
-                    value = true;
-                    break;
-                case ArgumentType::Action:
-                    value = arg->value();
-                    break;
-                default:
-                    break;
-                }
-
-                arg->callback()( value );
-            }
-        }
-        delete input;
+        m_loadedNamespaces.insert( id );
+        CommandLineInterfaceBuilder builder( self );
+        m_namespaces->loader( id )( builder );
     }
-
-    return *this;
+    m_pendingNamespaces.storeRelease( m_namespaces->count() - m_loadedNamespaces.count() );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-InputArgument* CommandLineInterface::parseInputArgument(int& index)
+void CommandLineInterface::loadAllNamespaces() const
 {
-    int numOfArguments = m_inputArguments.count();
-    InputArgument* input = new InputArgument( m_inputArguments.at(index), m_acceptedArgumentPrefixs );
+    if ( m_pendingNamespaces.loadAcquire() == 0 ) return;
+    loadNamespaces( m_namespaces->namespaces() );
+}
 
-    if ( ( numOfArguments > 1 ) && (index < numOfArguments - 1 ) && input->isValid() && !input->hasValue() )
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addArgumentDependency(const QString key, const QString dependencyKey)
+{
+    ++m_uncacheableRegistrations;
+    Argument* arg = m_arguments.value( normilizeKey( key ), nullptr );
+    Argument* dependency = m_arguments.value( normilizeKey( dependencyKey ), nullptr );
+    if ( ( arg == nullptr ) || ( dependency == nullptr ) )
     {
-        bool isNextArgumentValid = InputArgument( m_inputArguments.at(index+1), m_acceptedArgumentPrefixs ).isValid();
-        if ( !isNextArgumentValid )
-        {
-            QString multiPartInput = QString("%1%2%3")
-                                            .arg(m_inputArguments.at(index))
-                                            .arg( input->nameValueSeperator().isEmpty() ? ":" : "" )
-                                            .arg(m_inputArguments.at(index+1));
+        Q_ASSERT_X( false, "CommandLineInterface::addArgumentDependency", QString("No argument with name %1").arg( arg == nullptr ? key : dependencyKey ).toLatin1().data() );
+        return;
+    }
 
-            delete input;
-            input = new InputArgument( multiPartInput , m_acceptedArgumentPrefixs );
-            ++index;
-        }
+    if ( ( arg == dependency ) || dependency->dependsOn( arg ) )
+    {
+        throw CircularDependencyException( arg->name(), dependency->name() );
     }
 
-    return input;
+    arg->addDependency( dependency );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QString CommandLineInterface::normilizeKey(const QString &key) const
+void CommandLineInterface::addArgumentValidator(const QString key, const ArgumentValidator& validator)
 {
-    return key.toLower();
+    ++m_uncacheableRegistrations;
+    Argument* arg = m_arguments.value( normilizeKey( key ), nullptr );
+    if ( arg == nullptr )
+    {
+        Q_ASSERT_X( false, "CommandLineInterface::addArgumentValidator", QString("No argument with name %1").arg( key ).toLatin1().data() );
+        return;
+    }
+
+    arg->addValidator( validator );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-QVariant CommandLineInterface::operator[](const QString key) const
+void CommandLineInterface::addConstraint(ConstraintKind kind, const QStringList& keys)
 {
-    QString normilizedKey = normilizeKey( key );
-    if ( m_arguments.contains(normilizedKey) )
+    ++m_uncacheableRegistrations;
+    QList<const Argument*> arguments;
+    foreach( const QString& key, keys )
     {
-        return m_arguments[normilizedKey]->value();
+        const Argument* arg = findArgument( normilizeKey( key ) );
+        if ( arg == nullptr )
+        {
+            Q_ASSERT_X( false, "CommandLineInterface::addConstraint", QString("No argument with name %1").arg( key ).toLatin1().data() );
+            return;
+        }
+        arguments.append( arg );
     }
-    else
+
+    switch ( kind )
     {
-        return QVariant();
+    case Required:
+        m_constraints->addRequired( arguments.first() );
+        break;
+    case Requires:
+        m_constraints->addRequires( arguments.first(), arguments.last() );
+        break;
+    case Exclusive:
+        m_constraints->addExclusive( arguments );
+        break;
+    case AtLeastOne:
+        m_constraints->addAtLeastOne( arguments );
+        break;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-CommandLineInterfaceBuilder CommandLineInterface::build()
+void CommandLineInterface::checkConstraints(const QSet<Argument*>& presentArguments) const
 {
-    return CommandLineInterfaceBuilder();
-}
+    if ( m_constraints->isEmpty() ) return;
 
-////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::addArgument(Argument* arg)
-{
-    validateArgumentName(*arg);
-    m_arguments[normilizeKey( arg->name() )] = arg;
+    foreach( const QString& key, QStringList( { HELPARGUMENT, QStringLiteral("?"), VERSIONARGUMENT } ) )
+    {
+        if ( presentArguments.contains( m_arguments.value( key, nullptr ) ) ) return;
+    }
 
-    if ( arg->hasShortName() )
+    QStringList violations = m_constraints->check( m_constraints->presence( presentArguments ) );
+    if ( !violations.isEmpty() )
     {
-        validateArgumentShortName(*arg);
-        m_arguments[normilizeKey( arg->shortName() )] = arg;
+        throw ConstraintViolationException( violations );
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::validateArgumentName(const Argument& arg) const
+void CommandLineInterface::addAlias(const QString alias, const QString key)
 {
-    QString normilizedName = normilizeKey( arg.name() );
-    if ( m_arguments.contains( normilizedName ) )
+    Argument* arg = findArgument( normilizeKey( key ) );
+    if ( arg == nullptr )
     {
-        if ( normilizedName == VERSIONARGUMENT )
-        {
-            throw VersionArgumentRedefinitionException();
-        }
-        else if (( normilizedName == HELPARGUMENT ) || ( normilizedName == "?" ))
-        {
-            // Ok to overide
-            qWarning("The built in help argument is being overriden");
-        }
-        else
-        {
-            throw ArgumentRedefinitionException(arg.name());
-        }
+        Q_ASSERT_X( false, "CommandLineInterface::addAlias", QString("No argument with name %1").arg( key ).toLatin1().data() );
+        return;
     }
+
+    validateAliasName( alias, arg );
+    m_arguments[normilizeKey( alias )] = arg;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::validateArgumentShortName(const Argument &arg) const
+void CommandLineInterface::addDeprecatedName(const QString deprecatedName, const QString key)
 {
-    QString normalizedName = normilizeKey( arg.name() );
-    if ( normalizedName == HELPARGUMENT ) return;
+    ++m_uncacheableRegistrations;
+    addAlias( deprecatedName, key );
+    m_deprecatedNames[normilizeKey( deprecatedName )] = key;
+}
 
-    QString normilizedShortName = normilizeKey( arg.shortName() );
-    if ( m_arguments.contains( normilizedShortName ) )
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::addPreset(const QString name, const QStringList& options)
+{
+    ++m_uncacheableRegistrations;
+    QString normilizedName = normilizeKey( name );
+    validateAliasName( name, nullptr );
+
+    QList<InputArgument> inputs;
+    foreach( const QString& option, options )
     {
-        if ( ( normilizedShortName == VERSIONARGUMENT.at(0) ) && m_arguments.contains(VERSIONARGUMENT) )
+        InputArgument input( option, m_acceptedArgumentPrefixs );
+        if ( !isOption( option ) )
         {
-            throw VersionShortNameCollisionException( arg.name() );
+            // Presets have no positional inputs, anything which isn't an option is the value of the option before it.
+            Q_ASSERT_X( !inputs.isEmpty() && !inputs.last().hasValue(), "CommandLineInterface::addPreset", QString("The preset %1 has a value without an option: %2").arg( name, option ).toLatin1().data() );
+            if ( !inputs.isEmpty() ) inputs.last().attachValue( option );
+            continue;
         }
-        else if (( normilizedShortName == HELPARGUMENT.at(0) ) || ( normilizedShortName == "?" ))
+
+        QString key = normilizeKey( input.name() );
+        if ( !input.hasValue() && m_presets->contains( key ) )
         {
-            throw HelpShortNameCollisionException( arg.name() );
+            inputs.append( m_presets->expansion( key ) );
         }
         else
         {
-            throw ShortNameCollisionException(arg.name(), m_arguments[normilizedShortName]->name());
+            inputs.append( input );
         }
     }
-}
 
+    m_presets->add( normilizedName, name, options, inputs );
+    m_renderedHelp.clear();
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::setVersion(const QString version)
+void CommandLineInterface::validateAliasName(const QString& name, const Argument* arg) const
 {
-    Q_ASSERT_X( !version.isEmpty(), "CLI::setVersion", "Version should not be empty." );
+    QString normilizedName = normilizeKey( name );
+    Argument* existing = m_arguments.value( normilizedName, nullptr );
 
-    m_version = version;
+    // Giving an argument a name it already answers to, like its own short name, changes nothing.
+    bool taken = ( existing != nullptr ) && ( existing != arg );
+    if ( taken || m_presets->contains( normilizedName ) || ( findPositionalArgument( normilizedName ) != nullptr ) )
+    {
+        throw ArgumentRedefinitionException( name );
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::setName(const QString name)
+void CommandLineInterface::reportDeprecatedName(const QString& normalizedKey) const
 {
-    m_applicationName = name;
+    auto it = m_deprecatedNames.constFind( normalizedKey );
+    if ( ( it == m_deprecatedNames.constEnd() ) || m_reportedDeprecations.contains( normalizedKey ) ) return;
+
+    m_reportedDeprecations.insert( normalizedKey );
+    qWarning( "%s", qPrintable( QString("The argument %1 is deprecated, use %2 instead").arg( normalizedKey, it.value() ) ) );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void CommandLineInterface::setDescription(const QString description)
+QStringList CommandLineInterface::reloadConfiguration()
 {
-    m_description = description;
+    ensureProcessed();
+    if ( m_processedState->configurationWatcher.isNull() ) return QStringList();
+
+    return m_processedState->configurationWatcher->reload();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -256,10 +1296,11 @@ void CommandLineInterface::addHelpArguments()
 ////////////////////////////////////////////////////////////////////////////////////////////////
 void CommandLineInterface::setValue(const QString key, const QVariant value)
 {
+    ensureProcessed();
     QString normilizedKey = normilizeKey( key );
     if ( m_arguments.contains(normilizedKey) )
     {
-        m_arguments[normilizedKey]->setValue(value);
+        m_values->setValue( m_arguments[normilizedKey], value );
     }
     else
     {
@@ -269,6 +1310,21 @@ void CommandLineInterface::setValue(const QString key, const QVariant value)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 QString CommandLineInterface::helpMessage() const
+{
+    PhaseTimer help( m_statistics.data(), ParseStatistics::Help );
+
+    // The layout only changes when the interface is being built, once rendered it is reused for the life of this interface.
+    QMutexLocker lock( m_lock.data() );
+    loadAllNamespaces();
+    if ( m_renderedHelp.isEmpty() )
+    {
+        m_renderedHelp = renderHelpMessage();
+    }
+    return m_renderedHelp;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::renderHelpMessage() const
 {
     QString applicationExecutable = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
     QString message = generateTitle();
@@ -283,23 +1339,73 @@ QString CommandLineInterface::helpMessage() const
         message += m_description + QStringLiteral("\n\n");
     }
 
-    message += QString("Usage: %1 [OPTION]\n\n").arg(applicationExecutable);
+    QString usage = applicationExecutable;
+    if ( !m_selectedCommands.isEmpty() )
+    {
+        usage += QStringLiteral(" ") + m_selectedCommands.join( QStringLiteral(" ") );
+    }
+    QString positionals;
+    foreach( Argument* arg, m_positionalArguments )
+    {
+        positionals += QStringLiteral(" ") + arg->name().toUpper();
+        if ( arg->type() == ArgumentType::PositionalList ) positionals += QStringLiteral("...");
+    }
+    // The usage holds the selected commands which came from the user, a single pass arg() keeps any
+    // placeholders they typed from being expanded by the following arguments.
+    message += QString("Usage: %1 [OPTION]%2%3\n\n").arg( usage, m_commands.isEmpty() ? QString() : QStringLiteral(" COMMAND"), positionals );
 
-    QStringList filterArgumentAliases;
-    foreach( Argument* arg, m_arguments.values() )
+    // Short names are aliases pointing at the same argument, a set keeps filtering them out linear.
+    QSet<const Argument*> listedArguments;
+    foreach( Argument* arg, m_arguments )
     {
-        if ( filterArgumentAliases.contains( arg->name() ) ) continue;
+        if ( arg->isHidden() || listedArguments.contains( arg ) ) continue;
         if ( arg->hasShortName() )
         {
-            message += QString( "  -%1, --%2").arg(arg->shortName()).arg(arg->name());
+            message += QString( "  -%1, --%2").arg( arg->shortName(), arg->name() );
+        }
+        else if ( arg->name().length() > 1 )
+        {
+            message += QString( "  --%1").arg(arg->name());
         }
         else
         {
             message += QString( "  -%1").arg(arg->name());
         }
 
-        message += QString("\t%1\n").arg(arg->description());
-        filterArgumentAliases.append( arg->name());
+        message += QString("\t%1").arg(arg->description());
+        if ( arg->hasChoices() )
+        {
+            message += QString(" {%1}").arg( arg->choices().choices().join( QChar('|') ) );
+        }
+        message += QStringLiteral("\n");
+        listedArguments.insert( arg );
+    }
+
+    if ( !m_presets->isEmpty() )
+    {
+        message += QStringLiteral("\nPresets:\n");
+        foreach( const QString& name, m_presets->names() )
+        {
+            message += QString("  --%1\t%2\n").arg( name, m_presets->options( normilizeKey( name ) ).join( QChar(' ') ) );
+        }
+    }
+
+    if ( !m_positionalArguments.isEmpty() )
+    {
+        message += QStringLiteral("\nArguments:\n");
+        foreach( Argument* arg, m_positionalArguments )
+        {
+            message += QString("  %1\t%2\n").arg(arg->name().toUpper()).arg(arg->description());
+        }
+    }
+
+    if ( !m_commands.isEmpty() )
+    {
+        message += QStringLiteral("\nCommands:\n");
+        for ( auto it = m_commands.constBegin(); it != m_commands.constEnd(); ++it )
+        {
+            message += QString("  %1\t%2\n").arg(it.key()).arg(it.value());
+        }
     }
     return message;
 }
@@ -337,3 +1443,296 @@ void CommandLineInterface::doVersionAction() const
     printf( "%s", generateTitle().toLatin1().data() );
     exit(0);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::doCompleteAction() const
+{
+    foreach( const QString& candidate, completions( m_completionPartial ) )
+    {
+        printf( "%s\n", candidate.toLocal8Bit().data() );
+    }
+    exit(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList CommandLineInterface::completions(const QString& partial) const
+{
+    QStringList candidates;
+    if ( m_inputArguments.contains( ENDOFOPTIONS ) ) return candidates;
+
+    if ( !m_inputArguments.isEmpty() && isOption( m_inputArguments.last() ) )
+    {
+        InputArgument previous( m_inputArguments.last(), m_acceptedArgumentPrefixs );
+        Argument* arg = previous.nameValueSeperator().isEmpty() ? findArgument( normilizeKey( previous.name() ) ) : nullptr;
+        if ( ( arg != nullptr ) && ( arg->type() == ArgumentType::String ) )
+        {
+            return completeValue( arg, QString(), partial );
+        }
+    }
+
+    InputArgument input( partial, m_acceptedArgumentPrefixs );
+    QString prefix = input.prefix();
+    if ( prefix.isEmpty() )
+    {
+        for ( auto it = m_commands.constBegin(); it != m_commands.constEnd(); ++it )
+        {
+            if ( it.key().startsWith( partial, Qt::CaseInsensitive ) ) candidates.append( it.key() );
+        }
+        if ( !partial.isEmpty() ) return candidates;
+
+        prefix = m_acceptedArgumentPrefixs.contains( QStringLiteral("--") ) ? QStringLiteral("--") : m_acceptedArgumentPrefixs.first();
+    }
+
+    QString name = partial.mid( prefix.length() );
+    QString seperator = input.nameValueSeperator();
+    if ( !seperator.isEmpty() )
+    {
+        int seperatorIndex = name.indexOf( seperator );
+        Argument* arg = findArgument( normilizeKey( name.left( seperatorIndex ) ) );
+        if ( ( arg == nullptr ) || ( arg->type() != ArgumentType::String ) ) return candidates;
+
+        int valueIndex = prefix.length() + seperatorIndex + seperator.length();
+        return completeValue( arg, partial.left( valueIndex ), partial.mid( valueIndex ) );
+    }
+
+    QString key = normilizeKey( name );
+    if ( m_pendingNamespaces.loadAcquire() > 0 )
+    {
+        loadNamespaces( m_namespaces->findByPrefix( key ) );
+    }
+
+    // Names starting with the key sort right after it, the walk stops at the first name which doesn't.
+    for ( auto it = m_arguments.lowerBound( key ); ( it != m_arguments.constEnd() ) && it.key().startsWith( key ); ++it )
+    {
+        const Argument* arg = it.value();
+        // Short names share the index, single letter names are left out since they're only ever given as -x
+        if ( arg->isHidden() || ( arg->name().length() < 2 ) || ( it.key() != normilizeKey( arg->name() ) ) ) continue;
+
+        candidates.append( prefix + arg->name() );
+    }
+
+    foreach( const QString& preset, m_presets->names( key ) )
+    {
+        candidates.append( prefix + preset );
+    }
+
+    return candidates;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList CommandLineInterface::completeValue(const Argument* arg, const QString& lead, const QString& partial) const
+{
+    QStringList candidates;
+    foreach( const QString& value, arg->completions( partial ) )
+    {
+        if ( value.startsWith( partial ) ) candidates.append( lead + value );
+    }
+    return candidates;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::completionScript(const QString shell, const QString program) const
+{
+    QString function = program;
+    function.replace( QRegularExpression( QStringLiteral("[^A-Za-z0-9_]") ), QStringLiteral("_") );
+
+    if ( shell == QStringLiteral("bash") )
+    {
+        // Bash splits --name=value into three words. Changing COMP_WORDBREAKS would change it for every other
+        // completion in the shell, so the words are joined back here and the candidates, which are whole words,
+        // are trimmed down to the part after the last = which is the word bash replaces.
+        return QStringLiteral(
+                    "_%1_complete()\n"
+                    "{\n"
+                    "    local IFS=$'\\n'\n"
+                    "    local -a words=( \"${COMP_WORDS[0]}\" )\n"
+                    "    local i\n"
+                    "    for (( i = 1; i <= COMP_CWORD; i++ )); do\n"
+                    "        if (( i > 1 )) && [[ ${COMP_WORDS[i]} == \"=\" || ${COMP_WORDS[i-1]} == \"=\" ]]; then\n"
+                    "            words[${#words[@]}-1]+=${COMP_WORDS[i]}\n"
+                    "        else\n"
+                    "            words+=( \"${COMP_WORDS[i]}\" )\n"
+                    "        fi\n"
+                    "    done\n"
+                    "    COMPREPLY=( $( \"${words[0]}\" %3 \"${words[@]:1}\" 2>/dev/null ) )\n"
+                    "    local cur=${words[${#words[@]}-1]}\n"
+                    "    if [[ $cur == *=* && $COMP_WORDBREAKS == *=* ]]; then\n"
+                    "        local lead=${cur%=*}\n"
+                    "        [[ ${COMP_WORDS[COMP_CWORD]} == \"=\" ]] || lead+=\"=\"\n"
+                    "        COMPREPLY=( \"${COMPREPLY[@]#\"$lead\"}\" )\n"
+                    "    fi\n"
+                    "}\n"
+                    "complete -o default -F _%1_complete %2\n" ).arg( function, program, COMPLETEARGUMENT );
+    }
+
+    if ( shell == QStringLiteral("zsh") )
+    {
+        return QStringLiteral(
+                    "#compdef %2\n"
+                    "_%1_complete()\n"
+                    "{\n"
+                    "    local -a candidates\n"
+                    "    candidates=( ${(f)\"$( ${words[1]} %3 \"${(@)words[2,CURRENT]}\" 2>/dev/null )\"} )\n"
+                    "    compadd -Q -a candidates\n"
+                    "}\n"
+                    "compdef _%1_complete %2\n" ).arg( function, program, COMPLETEARGUMENT );
+    }
+
+    if ( shell == QStringLiteral("fish") )
+    {
+        return QStringLiteral(
+                    "function __%1_complete\n"
+                    "    set -l words (commandline -opc)\n"
+                    "    set -e words[1]\n"
+                    "    %2 %3 $words (commandline -ct) 2>/dev/null\n"
+                    "end\n"
+                    "complete -c %2 -a '(__%1_complete)'\n" ).arg( function, program, COMPLETEARGUMENT );
+    }
+
+    return QString();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList< QPair<Argument*, QVariant> > CommandLineInterface::changedValues() const
+{
+    loadAllNamespaces();
+
+    QList< QPair<Argument*, QVariant> > values;
+    for ( auto it = m_arguments.constBegin(); it != m_arguments.constEnd(); ++it )
+    {
+        Argument* arg = it.value();
+
+        // Short names and aliases share the index, each argument is only looked at under its own name.
+        if ( it.key() != normilizeKey( arg->name() ) ) continue;
+        if ( ( arg->type() != ArgumentType::String ) && ( arg->type() != ArgumentType::Boolean ) ) continue;
+        if ( arg == m_statisticsArgument ) continue;
+
+        QVariant value = m_values->value( arg );
+        if ( value != arg->value() ) values.append( qMakePair( arg, value ) );
+    }
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString CommandLineInterface::canonicalValue(const Argument* arg, const QVariant& value) const
+{
+    if ( arg->hasChoices() ) return arg->choices().choices().value( value.toInt() );
+    if ( arg->isPayload() ) return value.value<Payload>().toString();
+    return value.toString();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList CommandLineInterface::canonicalArguments() const
+{
+    ensureProcessed();
+    QString prefix = m_acceptedArgumentPrefixs.contains( QStringLiteral("--") ) ? QStringLiteral("--") : m_acceptedArgumentPrefixs.first();
+
+    QStringList arguments = m_selectedCommands;
+    for ( auto changed : changedValues() )
+    {
+        const Argument* arg = changed.first;
+        if ( arg->type() == ArgumentType::Boolean )
+        {
+            if ( changed.second.toBool() ) arguments.append( prefix + arg->name() );
+            continue;
+        }
+
+        // An empty value can't be written as name=value, it would read as a flag, so it follows the name as its own input.
+        QString value = canonicalValue( arg, changed.second );
+        if ( value.isEmpty() )
+        {
+            arguments << ( prefix + arg->name() ) << value;
+        }
+        else
+        {
+            arguments.append( QString("%1%2=%3").arg( prefix, arg->name(), value ) );
+        }
+    }
+
+    // The end of options marker is only needed when a positional input would otherwise be read as an option.
+    QStringList positionals = positionalArguments().toStringList();
+    foreach( const QString& input, positionals )
+    {
+        if ( ( input == ENDOFOPTIONS ) || isOption( input ) )
+        {
+            arguments.append( ENDOFOPTIONS );
+            break;
+        }
+    }
+    return arguments + positionals;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QByteArray CommandLineInterface::serializedValues() const
+{
+    ensureProcessed();
+    QList< QPair<Argument*, QVariant> > values = changedValues();
+
+    QByteArray data;
+    QDataStream out( &data, QIODevice::WriteOnly );
+    out.setVersion( QDataStream::Qt_5_0 );
+    out << SERIALIZEDMAGIC << SERIALIZEDFORMATVERSION << m_selectedCommands << quint32( values.count() );
+    for ( auto changed : values )
+    {
+        // Payloads are written as they were given, the child maps the file itself when it needs the data.
+        QVariant value = changed.first->isPayload() ? QVariant( canonicalValue( changed.first, changed.second ) ) : changed.second;
+        out << changed.first->name() << value;
+    }
+    out << positionalArguments().toStringList();
+    return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterface::setSerializedValues(const QByteArray& values)
+{
+    QDataStream in( values );
+    in.setVersion( QDataStream::Qt_5_0 );
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QStringList commands;
+    in >> magic >> version;
+    if ( ( magic != SERIALIZEDMAGIC ) || ( version != SERIALIZEDFORMATVERSION ) ) return false;
+
+    in >> commands;
+    if ( in.status() != QDataStream::Ok ) return false;
+
+    // The commands become the only inputs so registering them selects the same ones the parent had.
+    m_serializedValues = values;
+    m_inputArguments = commands;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void CommandLineInterface::restoreSerializedValues()
+{
+    QDataStream in( m_serializedValues );
+    in.setVersion( QDataStream::Qt_5_0 );
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QStringList commands;
+    quint32 count = 0;
+    in >> magic >> version >> commands >> count;
+
+    m_values->beginBatch();
+    for ( quint32 i = 0; ( i < count ) && ( in.status() == QDataStream::Ok ); ++i )
+    {
+        QString name;
+        QVariant value;
+        in >> name >> value;
+
+        Argument* arg = findArgument( normilizeKey( name ) );
+        if ( arg == nullptr ) continue;
+        m_values->setValue( arg, arg->isPayload() ? QVariant::fromValue( Payload( value.toString() ) ) : value );
+    }
+    m_values->commitBatch();
+
+    // Whatever inputs are left over from selecting the commands are replaced by the parents positional inputs.
+    QStringList positionals;
+    in >> positionals;
+    m_inputArguments = positionals;
+    assignPositionalArguments( QVector< QPair<int, int> >( { qMakePair( 0, positionals.count() ) } ) );
+
+    m_processedState->processed.storeRelease( 1 );
+}
@@ -26,9 +26,24 @@
 
 #include <QObject>
 #include <QMap>
+#include <QSet>
 #include <QVariant>
 #include <QStringList>
+#include <QSharedPointer>
+#include <QVector>
+#include <QPair>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QHash>
+#include <QRegularExpression>
 #include "CommandLineInterfaceBuilder.hpp"
+#include "ArgumentSpan.hpp"
+#include "ArgumentSubtree.hpp"
+#include "Payload.hpp"
+#include "ParseStatistics.hpp"
+
+class QThreadPool;
+class QMutex;
 
 namespace Taranis
 {
@@ -36,16 +51,32 @@ namespace Taranis
     {
         class TaranisTestSuite;
     }
+    namespace Fuzz
+    {
+        class FuzzHarness;
+    }
     namespace Internal
     {
         class Argument;
         class InputArgument;
+        class ValueStore;
+        class ConfigurationWatcher;
+        class NamespaceTrie;
+        class ConstraintSet;
+        class PresetTable;
+        class Interpolator;
+        class ArgumentValidator;
     }
 
     /**
      * @brief The CommandLineInterface class represents a command line interface.
      * Your application will accept command line arguments which are defined in the CommandLineInterface object.
      *
+     * Reading argument values through the index operator is thread safe and never blocks, values are kept in an immutable
+     * snapshot which is swapped atomically when values change. Arguments bound to your own variables or properties are the
+     * exception, reading them through the index operator waits for any write in progress. Reading the variable itself on
+     * another thread while a configuration reload writes it is up to you to synchronize.
+     *
      * @warning If your build the CommandLineInterface wtih arguments which collide, that is
      * arguments with the same name or have the same short names and this includes the two built in
      * arguments <i>help</i> and <i>version</i> then exceptions will be thrown alerting you of the
@@ -55,6 +86,7 @@ namespace Taranis
     {
         friend class CommandLineInterfaceBuilder;
         friend class UnitTest::TaranisTestSuite;
+        friend class Fuzz::FuzzHarness;
     public:
         CommandLineInterface() = delete;
         virtual ~CommandLineInterface();
@@ -64,6 +96,13 @@ namespace Taranis
         QString description() const;
         QStringList arguments() const;
 
+        /**
+         * @brief command returns the subcommand the user selected on the command line.
+         * @return Returns the name of the selected command, nested commands are separated by a space, or an empty string if no command was selected.
+         * @see CommandLineInterfaceBuilder::WithCommand()
+         */
+        QString command() const;
+
         /**
          * @brief You can use the index operator to access argument values.
          * @param key is the key or name of the argument whose value you are looking for. This look up is case insensitive.
@@ -71,6 +110,114 @@ namespace Taranis
          */
         QVariant operator[](const QString key) const;
 
+        /**
+         * @brief positionalArguments returns every input which is not an option.
+         * This includes everything after the <i>--</i> end of options marker, even inputs which look like options.
+         * @return Returns a span over the positional inputs in the order they were given.
+         */
+        ArgumentSpan positionalArguments() const;
+
+        /**
+         * @brief positional returns the inputs assigned to a positional argument.
+         * @param name is the name of the positional argument. This look up is case insensitive.
+         * @return Returns a span over the inputs assigned to the argument, which is empty if the argument does not exist or was not provided.
+         * @see CommandLineInterfaceBuilder::WithPositional(), CommandLineInterfaceBuilder::WithPositionalList()
+         */
+        ArgumentSpan positional(const QString name) const;
+
+        /**
+         * @brief subtree returns the options under a dotted path, such as every db.primary.* option for db.primary.
+         * The subtree is a range of the sorted index of option names so it is found without looking at the options outside
+         * of it and values are read through the subtree rather than copied into it. Any namespace along or under the
+         * path is loaded first.
+         * @param path is the dotted path of the subtree. This look up is case insensitive.
+         * @return Returns a view over the options under the path, which is empty if there are none.
+         */
+        ArgumentSubtree subtree(const QString path) const;
+
+        /**
+         * @brief setValue allows you to change the value of an argument after the command line has been processed.
+         * The new value is published atomically so other threads reading through the index operator will see either the
+         * old or the new value. The arguments action handler is not executed.
+         * @param key is the key or name of the argument whose value you want to change. This look up is case insensitive.
+         * @param value is the new value of the argument.
+         */
+        void setValue( const QString key, const QVariant value );
+
+        /**
+         * @brief reloadConfiguration will re-read the configuration files and apply any values which changed.
+         * Only arguments which took their value from a configuration file are updated, arguments provided on the command
+         * line or through the environment keep their values. Stored values are swapped in all at once so other threads
+         * reading through the index operator never see a mix of old and new values, then the actions of the changed
+         * arguments are executed. The changed values are checked against the choices and validators of their arguments
+         * first, if any of them fails a ValidationException is thrown and every argument keeps its old value.
+         *
+         * This is done automatically when the configuration files change if the interface was built with
+         * CommandLineInterfaceBuilder::WithConfigFileWatching() which is also required for this method to do anything.
+         *
+         * @return Returns the names of the arguments whose value changed.
+         */
+        QStringList reloadConfiguration();
+
+        /**
+         * @brief actionsFinished lets you wait for the action handlers which are executed on a thread pool.
+         * @return Returns a future which finishes once every deferred action handler has finished. If the actions are not
+         * executed asynchronously the returned future is already finished. A handler which throws does not stop the others,
+         * waiting on the future rethrows the exception, anything which is not a QException as a QUnhandledException.
+         * @see CommandLineInterfaceBuilder::WithAsyncActions()
+         */
+        QFuture<void> actionsFinished() const;
+
+        /**
+         * @brief statistics returns the time and allocations spent building and processing the command line interface.
+         * @return Returns a copy of the statistics recorded so far, which is empty unless the interface was built with
+         * CommandLineInterfaceBuilder::WithStatistics().
+         */
+        ParseStatistics statistics() const;
+
+        /**
+         * @brief completionScript generates a script which hooks your application into a shell's tab completion.
+         * The script doesn't list the arguments itself, on every Tab press the shell runs your application with the hidden
+         * <i>--__complete</i> argument followed by the words typed so far. Your application answers with one candidate
+         * per line and exits without processing the command line, see CommandLineInterfaceBuilder::WithCompletion()
+         * for completing values.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterfaceBuilder()
+         *                            .WithAction("completion", "Print the bash completion script.", [&cli](QVariant) {
+         *                                printf( "%s", cli.completionScript("bash", "coolapp").toLatin1().data() );
+         *                                exit(0);
+         *                            });
+         * @endcode
+         *
+         * @param shell is the shell to generate the script for, which is one of bash, zsh, or fish.
+         * @param program is the name the application is run as, such as coolapp.
+         * @return Returns the script or an empty string if the shell is not supported.
+         */
+        QString completionScript(const QString shell, const QString program) const;
+
+        /**
+         * @brief canonicalArguments gives the smallest command line which reproduces the values of this one.
+         * It holds the selected commands, every option whose value differs from its default by its long name with the value
+         * after an = sign, and the positional inputs. Values from configuration files and the environment are included so
+         * a child process started with it needs neither. Arguments with an action handler don't keep their value and are
+         * left out.
+         *
+         * @code{.cpp}
+         * QProcess::startDetached( QCoreApplication::applicationFilePath(), cli.canonicalArguments() );
+         * @endcode
+         *
+         * @return Returns the options in name order, which is the same for any command line giving the same values.
+         */
+        QStringList canonicalArguments() const;
+
+        /**
+         * @brief serializedValues gives the same values as canonicalArguments() in a compact binary form.
+         * A child process passes them to CommandLineInterfaceBuilder::WithSerializedValues() to get the values back without
+         * processing a command line.
+         */
+        QByteArray serializedValues() const;
+
         /**
          * @brief build is a static helper method to easily access a builder of CommandLineInterface objects.
          * @return Returns a command line interface builder.
@@ -78,6 +225,8 @@ namespace Taranis
         static CommandLineInterfaceBuilder build();
 
     protected:
+        enum ConstraintKind { Required, Requires, Exclusive, AtLeastOne };
+
         explicit CommandLineInterface(const QString applicationName, QStringList arguments, QStringList acceptedArgumentPrefixes);
 
         /**
@@ -85,30 +234,295 @@ namespace Taranis
          */
         virtual CommandLineInterface& process();
 
+        /**
+         * @brief helpMessage returns the help text, it is rendered the first time it is asked for and reused after that.
+         * The text is only kept in memory. Unlike the version, answering <i>--help</i> needs every argument so the interface
+         * is built in full and the help is rendered once per process, a schema cache only makes building it cheaper.
+         */
         virtual QString helpMessage() const;
+        QString renderHelpMessage() const;
         virtual void doHelpAction() const;
         virtual void doVersionAction() const;
+
+        /**
+         * @brief doCompleteAction prints the completions of the word being typed, one per line, and exits.
+         */
+        virtual void doCompleteAction() const;
+
+        /**
+         * @brief completions finds what the word being typed could become.
+         * Option names are taken from a range of the sorted index of names so only the options which match are looked at.
+         * If the word is the value of an option, given as the next input or after a seperator, the options completion
+         * provider is asked instead.
+         * @param partial is the word being typed, the words before it are the inputs of this interface.
+         */
+        QStringList completions( const QString& partial ) const;
+        QStringList completeValue( const Internal::Argument* arg, const QString& lead, const QString& partial ) const;
         virtual QString generateTitle() const;
         void addArgument( Internal::Argument* arg );
+        void addPositionalArgument( Internal::Argument* arg );
+        Internal::Argument* findPositionalArgument( const QString& key ) const;
+
+        /**
+         * @brief assignPositionalArguments hands the positional inputs out to the declared positional arguments.
+         * @param runs are the contiguous runs of positional inputs, as an index into the inputs and a count.
+         */
+        void assignPositionalArguments( const QVector< QPair<int, int> >& runs );
         void setVersion( const QString version );
         void setName( const QString name );
         void setDescription( const QString description );
+        void addConfigurationFile( const QString path );
+        void setEnvironmentPrefix( const QString prefix );
+        void setWatchConfigurationFiles( bool watch );
+        void setDeferActions( bool defer );
+        void setArgumentPriority( const QString key, int priority );
+        void setActionThreadPool( QThreadPool* pool );
+        void addArgumentDependency( const QString key, const QString dependencyKey );
+        void addArgumentValidator( const QString key, const Internal::ArgumentValidator& validator );
+
+        /**
+         * @brief addConstraint adds a rule about which of the given arguments must or must not be present.
+         * The names are looked up the same as values are, loading the namespaces they fall under if need be.
+         */
+        void addConstraint( ConstraintKind kind, const QStringList& keys );
+
+        /**
+         * @brief checkConstraints throws a ConstraintViolationException listing every rule the given arguments break.
+         * Nothing is checked when help or the version is asked for, those exit before any value is used.
+         * @param presentArguments are the arguments given a value by the command line, configuration files or environment.
+         */
+        void checkConstraints( const QSet<Internal::Argument*>& presentArguments ) const;
+
+        /**
+         * @brief addAlias adds another name for an argument to the lookup, it is found the same as the arguments own names.
+         * @throws ArgumentRedefinitionException if the alias is already the name of a different argument or a preset.
+         */
+        void addAlias( const QString alias, const QString key );
+
+        /**
+         * @brief addDeprecatedName adds an alias which warns the first time it is used.
+         */
+        void addDeprecatedName( const QString deprecatedName, const QString key );
+
+        /**
+         * @brief addPreset lexes the options a preset stands for, presets named among them are expanded in place.
+         * @throws ArgumentRedefinitionException if the name is already taken.
+         */
+        void addPreset( const QString name, const QStringList& options );
+        void reportDeprecatedName( const QString& normalizedKey ) const;
+        void validateAliasName( const QString& name, const Internal::Argument* arg ) const;
+
+        /**
+         * @brief validateValues throws a ValidationException listing every value which fails its arguments validators.
+         * Checks which stat files are run on the action thread pool, or the global pool if there isn't one.
+         */
+        void validateValues( const QList< QPair<Internal::Argument*, QVariant> >& values ) const;
+
+        /**
+         * @brief compiledPattern compiles and optimizes a pattern the first time it is used, arguments sharing a pattern share the compiled expression.
+         * The pattern has to match the whole value.
+         */
+        QRegularExpression compiledPattern( const QString& pattern );
+        void setLazyParsing( bool lazy );
+        void setInterpolation( bool interpolate );
+
+        /**
+         * @brief setSerializedValues checks values written by serializedValues() and selects the commands they were written under.
+         * @return Returns false, leaving the interface untouched, if the values were not written by a compatible version.
+         */
+        bool setSerializedValues( const QByteArray& values );
+
+        /**
+         * @brief restoreSerializedValues stores the values given to setSerializedValues() in place of processing the command line.
+         */
+        void restoreSerializedValues();
+
+        /**
+         * @brief changedValues collects the options whose value differs from their default, in name order.
+         */
+        QList< QPair<Internal::Argument*, QVariant> > changedValues() const;
+        QString canonicalValue( const Internal::Argument* arg, const QVariant& value ) const;
+
+        /**
+         * @brief isVersionOnlyRequest tells if the only input is the version argument or its short name.
+         */
+        bool isVersionOnlyRequest() const;
+
+        /**
+         * @brief loadSchemaCache registers the arguments stored in a schema cache without validating them again.
+         * @return Returns false, leaving the interface untouched, if the cache can't be used or any of its names are already taken.
+         */
+        bool loadSchemaCache( const QString& path, const QByteArray& manifestHash );
+
+        /**
+         * @brief saveSchemaCache writes every argument registered since the given snapshot to a schema cache.
+         * Nothing is written if any of those arguments can't be cached.
+         * @param existingArguments are the arguments which were registered before the snapshot.
+         * @param existingPositionalCount is how many positional arguments were registered before the snapshot.
+         */
+        void saveSchemaCache( const QString& path, const QByteArray& manifestHash, const QSet<Internal::Argument*>& existingArguments, int existingPositionalCount ) const;
+        void addNamespace( const QString& path, std::function<void(CommandLineInterfaceBuilder&)> loader );
+
+        /**
+         * @brief findArgument looks up an option, loading the namespaces the key falls under if it isn't registered yet.
+         * @param normalizedKey is the normalized name or short name of the option.
+         * @return Returns the option or nullptr if there is no such option.
+         */
+        Internal::Argument* findArgument( const QString& normalizedKey ) const;
+
+        /**
+         * @brief interpolatedValue reads the value of an option with its placeholders expanded if interpolation is on.
+         * @throws InterpolationCycleException if the value references itself, directly or through other values.
+         */
+        QVariant interpolatedValue( const Internal::Argument* arg ) const;
+
+        /**
+         * @brief loadNamespaces calls the loaders of the given namespaces which this interface has not loaded yet.
+         */
+        void loadNamespaces( const QList<int>& namespaces ) const;
+        void loadAllNamespaces() const;
+
+        /**
+         * @brief requiresEagerProcessing is the quick scan done up front in lazy mode.
+         * Only the names of the options are looked at, nothing is converted or stored.
+         * @return Returns true if processing has an effect outside of this object. That is the case when an action,
+         * callback or bound argument is on the command line, or when values can come from configuration files or the environment.
+         * It is also true when processing could throw, because there are constraints or a choice argument or an argument
+         * with validators is on the command line.
+         */
+        bool requiresEagerProcessing() const;
+
+        /**
+         * @brief ensureProcessed runs the deferred process() the first time a value is needed in lazy mode.
+         * Concurrent readers wait for the one which does the processing.
+         */
+        void ensureProcessed() const;
+
+        /**
+         * @brief enableStatistics starts recording statistics and adds the hidden <i>taranis-stats</i> argument.
+         * @param traceFile is where to write the Chrome trace once the command line is processed, or empty for no trace.
+         */
+        void enableStatistics( const QString traceFile );
+        void writeStatistics( bool requested ) const;
+
+        /**
+         * @brief applyValue hands the value to the arguments callback or stores it.
+         * When actions are deferred the callback is queued instead and executed by runPendingActions(), unless it is help or version.
+         */
+        void applyValue( Internal::Argument* arg, const QVariant& value );
+
+        /**
+         * @brief isBuiltInAction tells if the argument is the help or version action.
+         * They print and exit the application so they always run straight away on the calling thread, even when actions are deferred.
+         */
+        bool isBuiltInAction( const Internal::Argument* arg ) const;
+
+        /**
+         * @brief toChoiceOrdinal looks up which of the choices of a choice argument the value is.
+         * @throws InvalidChoiceException if the value is not one of the choices.
+         */
+        int toChoiceOrdinal( const Internal::Argument* arg, const QString& value ) const;
+
+        /**
+         * @brief runPendingActions executes the queued callbacks in priority order, callbacks with equal priority run in the order they were queued.
+         * A callback only runs once the callbacks of the arguments it depends on have finished. If an action thread pool
+         * is set the callbacks are executed on it and this returns straight away, see actionsFinished().
+         */
+        void runPendingActions();
+        void addCommand( const QString name, const QString description );
+        void selectCommand( int index, const QString name );
+        bool isOption( const QString& input ) const;
+
+        /**
+         * @brief firstPositionalIndex finds the first input which is not an option, or the value of an option added so far.
+         * @return Returns the index of the first positional input, or -1 if there are none before the end of the options.
+         */
+        int firstPositionalIndex() const;
         void addHelpArguments();
-        void setValue( const QString key, const QVariant value );
         virtual QString normilizeKey( const QString& key ) const;
         virtual void validateArgumentName(const Internal::Argument& arg) const;
         virtual void validateArgumentShortName(const Internal::Argument& arg) const;
-        virtual Internal::InputArgument* parseInputArgument(int& index);
+        virtual Internal::InputArgument parseInputArgument(int& index);
+
+        /**
+         * @brief collectLayeredValues finds the values in the environment or configuration files for every argument not provided on the command line.
+         * Values are layered so defaults are overridden by configuration files, which are overridden by the environment, which in turn is
+         * overridden by the command line. The configuration files are only read if there is at least one argument left to look up.
+         * Nothing is applied, the values are returned so they can be checked along with the command line first.
+         * @param providedArguments are the arguments which were present on the command line.
+         * @param watcher is set to a watcher for the arguments left to the configuration files, if they are to be watched.
+         * @return Returns the values to apply, in name order.
+         */
+        virtual QList< QPair<Internal::Argument*, QVariant> > collectLayeredValues( const QSet<Internal::Argument*>& providedArguments, QSharedPointer<Internal::ConfigurationWatcher>& watcher );
+        virtual QByteArray environmentVariableName( const QString& key ) const;
 
     private:
+        /**
+         * @brief The ProcessedState struct holds what processing the command line produces besides the values.
+         * Copies of an interface share it along with the value store, so in lazy mode the first copy to be read
+         * processes the command line for all of them and none of them processes it again.
+         */
+        struct ProcessedState
+        {
+            QAtomicInt processed;
+            QStringList positionalInputs;
+            int positionalOffset;
+            int positionalCount;
+            QMap<QString, QPair<int, int> > positionalRanges;
+            QSharedPointer<Internal::ConfigurationWatcher> configurationWatcher;
+            QFuture<void> actionsFinished;
+
+            ProcessedState() : processed( 0 ), positionalOffset( 0 ), positionalCount( 0 ) {}
+        };
+
         QString m_applicationName;
         QString m_version;
         QString m_description;
         QMap<QString, Internal::Argument*> m_arguments;
         QStringList m_inputArguments;
         QStringList m_acceptedArgumentPrefixs;
+        QStringList m_configurationFiles;
+        QString m_environmentPrefix;
+        QSharedPointer<Internal::ValueStore> m_values;
+        bool m_watchConfigurationFiles;
+        bool m_deferActions;
+        QList< QPair<Internal::Argument*, QVariant> > m_pendingActions;
+        QThreadPool* m_actionThreadPool;
+        bool m_lazyParsing;
+        QSharedPointer<ProcessedState> m_processedState;
+        bool m_answeringVersion;
+        bool m_completing;
+        QString m_completionPartial;
+        QSharedPointer<QMutex> m_lock;
+        mutable QString m_renderedHelp;
+        QSharedPointer<Internal::NamespaceTrie> m_namespaces;
+        QSharedPointer<Internal::ConstraintSet> m_constraints;
+        QSharedPointer<Internal::PresetTable> m_presets;
+        QSharedPointer<Internal::Interpolator> m_interpolator;
+        QByteArray m_serializedValues;
+        QHash<QString, QString> m_deprecatedNames;
+        mutable QSet<QString> m_reportedDeprecations;
+        QHash<QString, QRegularExpression> m_patterns;
+        mutable QSet<int> m_loadedNamespaces;
+        mutable QAtomicInt m_pendingNamespaces;
+        QElapsedTimer m_constructionClock;
+        quint64 m_constructionAllocations;
+        quint64 m_constructionBytes;
+        QSharedPointer<ParseStatistics> m_statistics;
+        QString m_traceFile;
+        Internal::Argument* m_statisticsArgument;
+        QMap<QString, QString> m_commands;
+        QStringList m_selectedCommands;
+        int m_commandDepth;
+        int m_uncacheableRegistrations;
+        QList<Internal::Argument*> m_positionalArguments;
         static const QString VERSIONARGUMENT;
         static const QString HELPARGUMENT;
+        static const QString ENDOFOPTIONS;
+        static const QString STATISTICSARGUMENT;
+        static const QString COMPLETEARGUMENT;
+        static const quint32 SERIALIZEDMAGIC;
+        static const quint32 SERIALIZEDFORMATVERSION;
     };
 
     /**
@@ -24,10 +24,14 @@
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <QDir>
+#include <QFile>
+#include <QThreadPool>
 #include "CommandLineInterfaceBuilder.hpp"
 #include "CommandLineInterface.hpp"
 #include "InputArgument.hpp"
 #include "Argument.hpp"
+#include "ArgumentValidator.hpp"
+#include "PresetTable.hpp"
 #include "TaranisExceptions.hpp"
 
 using namespace Taranis;
@@ -35,9 +39,34 @@ using namespace Taranis::Internal;
 using namespace Taranis::Exceptions;
 using action_callback = std::function<void(QVariant)>;
 
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    Argument* createBoundArgument(const QString &name, const QString &description, ArgumentType type, const ArgumentBinding& binding)
+    {
+        auto arg = new Argument( name, description, type, nullptr );
+
+        // What the storage holds now is the default, it is restored if a reloaded configuration drops the value.
+        arg->setValue( binding.read() );
+        arg->setBinding( binding );
+        return arg;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    QStringList toArgumentList(int argc, char* argv[])
+    {
+        QStringList arguments;
+        for ( int i = 1; i < argc; ++i )
+        {
+            arguments.append( QString::fromLocal8Bit( argv[i] ) );
+        }
+        return arguments;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder::CommandLineInterfaceBuilder()
-    : CommandLineInterfaceBuilder( "", QCoreApplication::arguments() )
+    : CommandLineInterfaceBuilder( "", QCoreApplication::arguments().mid(1) )
 {
     if ( qApp == nullptr )
     {
@@ -46,13 +75,22 @@ CommandLineInterfaceBuilder::CommandLineInterfaceBuilder()
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterfaceBuilder &other)
+CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(int argc, char* argv[])
+    : CommandLineInterfaceBuilder( "", toArgumentList( argc, argv ) )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterfaceBuilder &other) :
+    m_ownsInterface( true )
 {
     *m_cli = *(other.m_cli);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterfaceBuilder &&other)
+CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterfaceBuilder &&other) :
+    m_ownsInterface( other.m_ownsInterface )
 {
     m_cli = other.m_cli;
     other.m_cli = nullptr;
@@ -61,11 +99,23 @@ CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterfaceBui
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder::~CommandLineInterfaceBuilder()
 {
-    delete m_cli;
+    if ( m_ownsInterface )
+    {
+        delete m_cli;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(CommandLineInterface* cli) :
+    m_cli( cli ),
+    m_ownsInterface( false )
+{
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(const QString applicationName, QStringList arguments)
+CommandLineInterfaceBuilder::CommandLineInterfaceBuilder(const QString applicationName, QStringList arguments) :
+    m_ownsInterface( true )
 {
      QStringList acceptedArgumentPrefixs = getAcceptedArgumentPrefixes();
      m_cli = new CommandLineInterface(applicationName, arguments, acceptedArgumentPrefixs);
@@ -92,17 +142,43 @@ CommandLineInterfaceBuilder::operator CommandLineInterface() const
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterface CommandLineInterfaceBuilder::getCommandLineInterface() const
 {
-    m_cli->process();
+    if ( m_cli->m_completing )
+    {
+        m_cli->doCompleteAction();
+        return *m_cli;
+    }
+
+    if ( !m_cli->m_serializedValues.isEmpty() )
+    {
+        m_cli->restoreSerializedValues();
+    }
+    else if ( !m_cli->m_lazyParsing || m_cli->requiresEagerProcessing() )
+    {
+        m_cli->process();
+    }
     return *m_cli;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterfaceBuilder::isAnsweringVersion() const
+{
+    return m_cli->m_answeringVersion;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool CommandLineInterfaceBuilder::isCompleting() const
+{
+    return m_cli->m_completing;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::operator=(CommandLineInterfaceBuilder &&other)
 {
     if ( this != &other )
     {
-        delete this->m_cli;
+        if ( m_ownsInterface ) delete this->m_cli;
         this->m_cli = other.m_cli;
+        this->m_ownsInterface = other.m_ownsInterface;
         other.m_cli = nullptr;
     }
     return *this;
@@ -130,7 +206,12 @@ CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithName(const QString
 CommandLineInterfaceBuilder& CommandLineInterfaceBuilder::WithVersion(const QString &version)
 {
     action_callback versionCallback = std::bind( &CommandLineInterface::doVersionAction, m_cli );
-    return WithVersion( version, versionCallback );
+    WithVersion( version, versionCallback );
+
+    // The built in version action prints and exits, when that is all the user asked for nothing
+    // registered from here on would ever be used so it isn't built.
+    m_cli->m_answeringVersion = m_cli->isVersionOnlyRequest();
+    return *this;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -152,34 +233,40 @@ CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithDescription(const
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithFlag(const QString &flag, const QString &description)
 {
-    m_cli->addArgument( new Argument( flag, description, ArgumentType::Boolean, [this, flag](QVariant){
-        m_cli->setValue(flag, true);
-    }));
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgument( new Argument( flag, description, ArgumentType::Boolean, nullptr ) );
     return *this;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithFlag(const QString &flag, const QString &description, action_callback action)
 {
+    if ( isAnsweringVersion() ) return *this;
     m_cli->addArgument( new Argument( flag, description, ArgumentType::Boolean, action) );
     return *this;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithFlag(const QString &flag, const QString &description, bool *value)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgument( createBoundArgument( flag, description, ArgumentType::Boolean, ArgumentBinding( value ) ) );
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description)
 {
-    m_cli->addArgument( new Argument( name, description, ArgumentType::String, [this, name](QVariant value){
-        m_cli->setValue(name, value);
-    }));
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgument( new Argument( name, description, ArgumentType::String, nullptr ) );
     return *this;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &defaultValue, const QString &description)
 {
-    auto arg = new Argument( name, description, ArgumentType::String, [this, name](QVariant value){
-        m_cli->setValue(name, value);
-    });
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = new Argument( name, description, ArgumentType::String, nullptr );
 
     arg->setValue( defaultValue );
     m_cli->addArgument( arg );
@@ -189,6 +276,7 @@ CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QStrin
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &defaultValue, const QString &description, std::function<void (QVariant)> action)
 {
+    if ( isAnsweringVersion() ) return *this;
     auto arg = new Argument( name, description, ArgumentType::String, action);
 
     arg->setValue( defaultValue );
@@ -199,13 +287,373 @@ CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QStrin
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description, action_callback action)
 {
+    if ( isAnsweringVersion() ) return *this;
     m_cli->addArgument( new Argument( name, description, ArgumentType::String, action) );
     return *this;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description, int *value)
+{
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = createBoundArgument( name, description, ArgumentType::String, ArgumentBinding( value ) );
+    arg->addValidator( ArgumentValidator::integer() );
+    m_cli->addArgument( arg );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description, double *value)
+{
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = createBoundArgument( name, description, ArgumentType::String, ArgumentBinding( value ) );
+    arg->addValidator( ArgumentValidator::number() );
+    m_cli->addArgument( arg );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description, QString *value)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgument( createBoundArgument( name, description, ArgumentType::String, ArgumentBinding( value ) ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithValue(const QString &name, const QString &description, QObject *object, const char *property)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgument( createBoundArgument( name, description, ArgumentType::String, ArgumentBinding( object, property ) ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithChoice(const QString &name, const QStringList &choices, const QString &description)
+{
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = new Argument( name, description, ArgumentType::String, nullptr );
+
+    arg->setChoices( ChoiceTable( choices ) );
+    m_cli->addArgument( arg );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithChoice(const QString &name, const QStringList &choices, const QString &defaultChoice, const QString &description)
+{
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = new Argument( name, description, ArgumentType::String, nullptr );
+    ChoiceTable table( choices );
+
+    int ordinal = table.ordinal( defaultChoice );
+    Q_ASSERT_X( ordinal >= 0, "WithChoice", "The default must be one of the choices." );
+    arg->setChoices( table );
+    if ( ordinal >= 0 ) arg->setValue( ordinal );
+    m_cli->addArgument( arg );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPayload(const QString &name, const QString &description)
+{
+    if ( isAnsweringVersion() ) return *this;
+    auto arg = new Argument( name, description, ArgumentType::String, nullptr );
+
+    arg->setPayload( true );
+    m_cli->addArgument( arg );
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithAction(const QString &name, const QString &description, action_callback action)
 {
+    if ( isAnsweringVersion() ) return *this;
    m_cli->addArgument( new Argument( name, description, ArgumentType::Action, action) );
     return *this;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPositional(const QString &name, const QString &description)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addPositionalArgument( new Argument( name, description, ArgumentType::Positional, nullptr ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPositionalList(const QString &name, const QString &description)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addPositionalArgument( new Argument( name, description, ArgumentType::PositionalList, nullptr ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithConfigFile(const QString &path)
+{
+    if ( isCompleting() ) return *this;
+    m_cli->addConfigurationFile( path );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithEnvironment(const QString &prefix)
+{
+    if ( isCompleting() ) return *this;
+    m_cli->setEnvironmentPrefix( prefix );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithConfigFileWatching()
+{
+    if ( isCompleting() ) return *this;
+    m_cli->setWatchConfigurationFiles( true );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithDeferredActions()
+{
+    m_cli->setDeferActions( true );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithLazyParsing()
+{
+    m_cli->setLazyParsing( true );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithInterpolation()
+{
+    m_cli->setInterpolation( true );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithSerializedValues(const QByteArray &values)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->setSerializedValues( values );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithSerializedValues(int fileDescriptor)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+
+    QFile file;
+    if ( !file.open( fileDescriptor, QIODevice::ReadOnly, QFileDevice::DontCloseHandle ) ) return *this;
+    return WithSerializedValues( file.readAll() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPriority(const QString &name, int priority)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->setArgumentPriority( name, priority );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithAsyncActions(QThreadPool *pool)
+{
+    if ( isCompleting() ) return *this;
+    m_cli->setDeferActions( true );
+    m_cli->setActionThreadPool( pool != nullptr ? pool : QThreadPool::globalInstance() );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithDependency(const QString &name, const QString &dependency)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addArgumentDependency( name, dependency );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithRequired(const QString &name)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addConstraint( CommandLineInterface::Required, { name } );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithRequires(const QString &name, const QString &requirement)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addConstraint( CommandLineInterface::Requires, { name, requirement } );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithExclusive(const QStringList &names)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addConstraint( CommandLineInterface::Exclusive, names );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithAtLeastOne(const QStringList &names)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addConstraint( CommandLineInterface::AtLeastOne, names );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithAlias(const QString &alias, const QString &name)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addAlias( alias, name );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithDeprecated(const QString &deprecatedName, const QString &name)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addDeprecatedName( deprecatedName, name );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPreset(const QString &name, const QStringList &options)
+{
+    if ( isAnsweringVersion() ) return *this;
+    m_cli->addPreset( name, options );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithRange(const QString &name, double minimum, double maximum)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addArgumentValidator( name, ArgumentValidator::range( minimum, maximum ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithPattern(const QString &name, const QString &pattern)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addArgumentValidator( name, ArgumentValidator::pattern( m_cli->compiledPattern( pattern ) ) );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithExistingFile(const QString &name)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addArgumentValidator( name, ArgumentValidator::existingFile() );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithExistingDirectory(const QString &name)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addArgumentValidator( name, ArgumentValidator::existingDirectory() );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithHostPort(const QString &name)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->addArgumentValidator( name, ArgumentValidator::hostPort() );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithStatistics(const QString &traceFile)
+{
+    if ( isAnsweringVersion() || isCompleting() ) return *this;
+    m_cli->enableStatistics( traceFile );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithSchemaCache(const QString &path, const QByteArray &manifestHash, std::function<void (CommandLineInterfaceBuilder &)> registration)
+{
+    if ( isAnsweringVersion() ) return *this;
+    if ( m_cli->loadSchemaCache( path, manifestHash ) ) return *this;
+
+    QMap<QString, Argument*> existingIndex = m_cli->m_arguments;
+    QSet<Argument*> existingArguments;
+    foreach( Argument* arg, existingIndex )
+    {
+        existingArguments.insert( arg );
+    }
+    int existingPositionalCount = m_cli->m_positionalArguments.count();
+    int existingUncacheableRegistrations = m_cli->m_uncacheableRegistrations;
+
+    registration( *this );
+
+    // The cache only holds arguments and their names. Registration which adds rules, commands, namespaces, presets or
+    // the like has to run every time, a cache would skip it.
+    if ( m_cli->m_uncacheableRegistrations != existingUncacheableRegistrations ) return *this;
+
+    // So does an alias of an argument registered before the cache, the cache only has the names of its own arguments.
+    for ( auto it = m_cli->m_arguments.constBegin(); it != m_cli->m_arguments.constEnd(); ++it )
+    {
+        if ( existingArguments.contains( it.value() ) && !existingIndex.contains( it.key() ) ) return *this;
+    }
+
+    m_cli->saveSchemaCache( path, manifestHash, existingArguments, existingPositionalCount );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithNamespace(const QString &name, std::function<void (CommandLineInterfaceBuilder &)> loader)
+{
+    if ( isAnsweringVersion() ) return *this;
+
+    m_cli->addNamespace( name, loader );
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithCompletion(const QString &name, std::function<QStringList (QString)> provider)
+{
+    if ( isAnsweringVersion() ) return *this;
+
+    Argument* arg = m_cli->m_arguments.value( m_cli->normilizeKey( name ), nullptr );
+    Q_ASSERT_X( arg != nullptr, "WithCompletion", "The argument must be added before its completion provider." );
+    if ( arg != nullptr )
+    {
+        arg->setCompletionProvider( provider );
+        ++m_cli->m_uncacheableRegistrations;
+    }
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+CommandLineInterfaceBuilder &CommandLineInterfaceBuilder::WithCommand(const QString &name, const QString &description, std::function<void (CommandLineInterfaceBuilder &)> builder)
+{
+    // Only commands at the level currently being dispatched are considered. Once a command
+    // has been selected its siblings are neither matched nor listed in the help.
+    if ( m_cli->m_selectedCommands.count() != m_cli->m_commandDepth ) return *this;
+
+    int index = m_cli->firstPositionalIndex();
+    if ( ( index < 0 ) || ( m_cli->normilizeKey( m_cli->m_inputArguments.at(index) ) != m_cli->normilizeKey( name ) ) )
+    {
+        m_cli->addCommand( name, description );
+        return *this;
+    }
+
+    m_cli->selectCommand( index, name );
+    ++m_cli->m_commandDepth;
+    builder( *this );
+    --m_cli->m_commandDepth;
+
+    return *this;
+}
@@ -28,6 +28,9 @@
 #include <QStringList>
 #include <functional>
 
+class QObject;
+class QThreadPool;
+
 namespace Taranis
 {
     namespace UnitTest
@@ -41,15 +44,34 @@ namespace Taranis
      * You can specify what arguments your CLI object will process as well as optionally set a name,
      * version, and description of your application which will be displayed in the built in help text.
      *
-     * @warning The QApplication object needs to exist before building a CommandLineInterface object. If
-     * you try to build a CLI object before the QApplication object exists an exception will be thrown
-     * alerting you of this fact.
+     * @warning The QApplication object needs to exist before building a CommandLineInterface object, unless
+     * the builder is handed the arguments of main. If you try to build a CLI object before the QApplication
+     * object exists an exception will be thrown alerting you of this fact.
      */
     class CommandLineInterfaceBuilder
     {
+        friend class CommandLineInterface;
         friend class UnitTest::TaranisTestSuite;
     public:
         CommandLineInterfaceBuilder();
+
+        /**
+         * @brief CommandLineInterfaceBuilder reads the inputs straight from the arguments of main so it can be used before
+         * the QApplication object exists. Building the interface first lets tab completion, which runs your application
+         * on every Tab press, be answered without paying for the rest of your application's start up.
+         *
+         * @code{.cpp}
+         * int main(int argc, char* argv[])
+         * {
+         *     CommandLineInterface cli = CommandLineInterfaceBuilder(argc, argv)
+         *                                .WithValue("host", "The server to connect to.")
+         *                                .WithCompletion("host", &knownHosts);
+         *     QApplication app(argc, argv);
+         *     ...
+         * }
+         * @endcode
+         */
+        CommandLineInterfaceBuilder(int argc, char* argv[]);
         CommandLineInterfaceBuilder(CommandLineInterfaceBuilder& other);
         CommandLineInterfaceBuilder(CommandLineInterfaceBuilder&& other);
         virtual ~CommandLineInterfaceBuilder();
@@ -114,6 +136,10 @@ namespace Taranis
          * My Cool App - Version 1.2.3.4-rc1
          * @endcode
          *
+         * When the version argument is the only input the arguments added after this call are never created, call it
+         * early in the chain so scripts asking for the version don't pay for building the whole interface. Asking for
+         * help still builds the whole interface since the help lists every argument.
+         *
          * @param version is the version of your application and can be any string.
          */
         CommandLineInterfaceBuilder& WithVersion(const QString& version );
@@ -233,6 +259,25 @@ namespace Taranis
          */
         CommandLineInterfaceBuilder& WithFlag( const QString& flag, const QString& description, std::function<void(QVariant)> action );
 
+        /**
+         * @brief WithFlag will add a flag to your CLI which is written straight into a variable you own.
+         * The variable is set to true if the user provides the flag, otherwise it keeps the value it had, which acts as the default.
+         *
+         * @code{.cpp}
+         * bool force = false;
+         * CommandLineInterface::build().WithFlag("force", "Will force a refresh.", &force);
+         * @endcode
+         *
+         * The variable must outlive the CommandLineInterface. Reading the flag through the index operator reads the variable.
+         * The variable is only written while processing the command line and on configuration reloads, reading it directly
+         * from another thread during a reload is not synchronized.
+         *
+         * @param flag is the name of the argument, example 'force'. You will get a short name, i.e. 'f', automatically.
+         * @param description is the description of this argument which will be displaied in the help.
+         * @param value is the variable the flag is written to.
+         */
+        CommandLineInterfaceBuilder& WithFlag( const QString& flag, const QString& description, bool* value );
+
         /**
          * @brief WithValue will add an agrument which expects a value to your CLI.
          * You can access the argument value by using the index operator with the arguments name.
@@ -297,6 +342,95 @@ namespace Taranis
          */
         CommandLineInterfaceBuilder& WithValue( const QString& name, const QString& defaultValue, const QString& description, std::function<void(QVariant)> action );
 
+        /**
+         * @brief WithValue will add an agrument which expects a value to your CLI and writes it straight into a variable you own.
+         * The users input is converted to the type of the variable as the command line is processed, there is no
+         * callback or look up involved. The value the variable holds beforehand acts as the default.
+         *
+         * @code{.cpp}
+         * struct Config { int port = 8080; double ratio = 0.5; QString host = "localhost"; } config;
+         * CommandLineInterface::build()
+         *          .WithValue("port", "The port to listen on.", &config.port)
+         *          .WithValue("ratio", "The compression ratio.", &config.ratio)
+         *          .WithValue("address", "The host to connect to.", &config.host);
+         * @endcode
+         *
+         * If the input can't be converted, such as <i>--port=abc</i>, a ValidationException is thrown and nothing is written.
+         * The variable must outlive the CommandLineInterface. Reading the argument through the index operator reads the variable.
+         *
+         * @param name is the name of the argument, example 'port'. You will get a short name, i.e. 'p', automatically.
+         * @param description is the description of this argument which will be displaied in the help.
+         * @param value is the variable the value is written to.
+         */
+        CommandLineInterfaceBuilder& WithValue( const QString& name, const QString& description, int* value );
+
+        /**
+         * @overload
+         */
+        CommandLineInterfaceBuilder& WithValue( const QString& name, const QString& description, double* value );
+
+        /**
+         * @overload
+         */
+        CommandLineInterfaceBuilder& WithValue( const QString& name, const QString& description, QString* value );
+
+        /**
+         * @brief WithValue will add an agrument which expects a value to your CLI and writes it to a property of a QObject.
+         * The property is looked up once when the argument is defined. If the object is destroyed the value is no longer written.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build().WithValue("title", "The window title.", &window, "windowTitle");
+         * @endcode
+         *
+         * @param name is the name of the argument, example 'title'. You will get a short name, i.e. 't', automatically.
+         * @param description is the description of this argument which will be displaied in the help.
+         * @param object is the object whose property the value is written to.
+         * @param property is the name of the property.
+         */
+        CommandLineInterfaceBuilder& WithValue( const QString& name, const QString& description, QObject* object, const char* property );
+
+        /**
+         * @brief WithChoice will add an argument whose value must be one of a fixed list of choices.
+         * The value is stored as the ordinal of the choice, its position in the list, so your code can switch on an int
+         * rather than compare strings every time it reads the value. Choices are matched ignoring case and a value which
+         * is not a choice throws an InvalidChoiceException. The help text lists the choices.
+         *
+         * @code{.cpp}
+         * enum LogLevel { Debug, Info, Warn };
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithChoice("log-level", {"debug", "info", "warn"}, "info", "Sets how much is logged.");
+         * LogLevel level = static_cast<LogLevel>( cli["log-level"].toInt() );
+         * @endcode
+         *
+         * @param name is the name of the argument, example 'log-level'. You will get a short name , i.e. 'l', automatically.
+         * @param choices are the values the argument accepts, in the order of their ordinals.
+         * @param description is the description of this argument which will be displaied in the help.
+         */
+        CommandLineInterfaceBuilder& WithChoice( const QString& name, const QStringList& choices, const QString& description );
+
+        /**
+         * @brief WithChoice will add an argument whose value must be one of a fixed list of choices.
+         * @param defaultChoice is the choice the argument has if it is not provided, it must be one of the choices.
+         */
+        CommandLineInterfaceBuilder& WithChoice( const QString& name, const QStringList& choices, const QString& defaultChoice, const QString& description );
+
+        /**
+         * @brief WithPayload will add an argument whose value is a large payload, such as a document or certificate bundle.
+         * The value can be given inline, as <i>@path</i> to use the contents of a file or as <i>-</i> to read stdin. It is
+         * stored as a Payload which doesn't read anything until you ask for the data, files are then memory mapped rather
+         * than copied into a string.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithPayload("policy", "The policy document, or @file to read it from a file.");
+         * QByteArray policy = cli["policy"].value<Payload>().data();
+         * @endcode
+         *
+         * @param name is the name of the argument, example 'policy'. You will get a short name , i.e. 'p', automatically.
+         * @param description is the description of this argument which will be displaied in the help.
+         */
+        CommandLineInterfaceBuilder& WithPayload( const QString& name, const QString& description );
+
 
         /**
          * @brief WithAction will add an argument which when present will trigger an action to be performed.
@@ -321,6 +455,507 @@ namespace Taranis
          */
         CommandLineInterfaceBuilder& WithAction( const QString& name, const QString& description, std::function<void(QVariant)> action );
 
+        /**
+         * @brief WithCommand will add a git style subcommand to your CLI.
+         * Each command has its own set of arguments which are defined by the builder function you provide. The builder
+         * function is only executed if the user selected the command so you don't pay for constructing the arguments of
+         * commands which are not in use.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithName("My Cool App")
+         *                                  .WithFlag("verbose", "Enables verbose logging.")
+         *                                  .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+         *                                        build.WithValue("jobs", "1", "Number of parallel jobs.");
+         *                                  })
+         *                                  .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder& deploy) {
+         *                                        deploy.WithValue("target", "Where to deploy to.");
+         *                                  });
+         *
+         * if ( cli.command() == "build" ) { build( cli["jobs"].toInt() ); }
+         * @endcode
+         *
+         * The command is the first input which is not an option, so in <i>mycoolapp --verbose build --jobs 8</i> the
+         * <i>build</i> command is selected. An option given before the command can have its value as the next input, such
+         * as <i>--config app.ini</i>, as long as the option is added before the command, otherwise it must use a seperator,
+         * such as <i>--config=app.ini</i>. Command names are case insensitive. Commands can be nested by calling this
+         * method from within a command's builder function.
+         *
+         * Unselected commands are listed in the built in help message.
+         *
+         * @param name is the name of the command, example 'build'.
+         * @param description is the description of this command which will be displaied in the help.
+         * @param builder is the function which adds the command's arguments to the CLI, it is only executed when the command is selected.
+         */
+        CommandLineInterfaceBuilder& WithCommand( const QString& name, const QString& description, std::function<void(CommandLineInterfaceBuilder&)> builder );
+
+        /**
+         * @brief WithPositional will add a positional argument to your CLI.
+         * Positional arguments are the inputs which are not options, they are assigned in the order they were declared.
+         * You can access the value by using the index operator with the arguments name.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithPositional("source", "The file to copy.")
+         *                                  .WithPositional("destination", "Where to copy the file to.");
+         * copy( cli["source"].toString(), cli["destination"].toString() );
+         * @endcode
+         *
+         * Everything after <i>--</i> is treated as a positional input, even if it looks like an option, so the user can
+         * provide a file named <i>-f</i> with <i>mycoolapp -- -f</i>.
+         *
+         * @param name is the name of the argument, example 'source'. It is displayed in upper case in the help.
+         * @param description is the description of this argument which will be displaied in the help.
+         */
+        CommandLineInterfaceBuilder& WithPositional( const QString& name, const QString& description );
+
+        /**
+         * @brief WithPositionalList will add a positional argument which collects any number of inputs to your CLI.
+         * The list takes all the positional inputs which are not claimed by the single positional arguments, including
+         * the ones declared after it, so <i>SOURCES... DESTINATION</i> works as you would expect.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build().WithPositionalList("files", "The files to compile.");
+         * for ( const QString& file : cli.positional("files") ) { compile( file ); }
+         * @endcode
+         *
+         * The inputs are returned as an ArgumentSpan over the inputs the CommandLineInterface holds onto, so none of them
+         * are copied no matter how many files the user passes in. Only one positional list can be defined.
+         *
+         * @param name is the name of the argument, example 'files'. It is displayed in upper case in the help.
+         * @param description is the description of this argument which will be displaied in the help.
+         */
+        CommandLineInterfaceBuilder& WithPositionalList( const QString& name, const QString& description );
+
+        /**
+         * @brief WithConfigFile will read values for your arguments from a configuration file.
+         * The file can either be an INI file or, if its name ends in <i>.json</i>, a JSON file. Keys in the file are
+         * matched case insensitively against the names of your arguments, INI sections and nested JSON objects are
+         * joined to the key with a dot.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("server", "127.0.0.1", "The IP address to the server.")
+         *                                  .WithConfigFile("/etc/mycoolapp.ini");
+         * @endcode
+         *
+         * @code{.unparsed}
+         * ; /etc/mycoolapp.ini
+         * server = 10.0.0.1
+         * @endcode
+         *
+         * Values are layered: the default value is overridden by the configuration file, which is overridden by the
+         * environment (see WithEnvironment), which is overridden by the command line. The file is only read if at least
+         * one argument was not provided on the command line and only the keys matching your arguments are loaded.
+         *
+         * You can call this method more then once, values in files added later override values in files added earlier.
+         * A file which does not exist is silently ignored.
+         *
+         * @param path is the path to the configuration file.
+         */
+        CommandLineInterfaceBuilder& WithConfigFile( const QString& path );
+
+        /**
+         * @brief WithEnvironment will read values for your arguments from environment variables.
+         * The name of the environment variable is the prefix, an underscore, then the name of the argument in upper case with
+         * any dashes or dots replaced by underscores.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("log-level", "info", "Sets the log level.")
+         *                                  .WithEnvironment("MYCOOLAPP");
+         * @endcode
+         *
+         * The above would read the <i>log-level</i> argument from the <i>MYCOOLAPP_LOG_LEVEL</i> environment variable
+         * unless it was provided on the command line.
+         *
+         * @param prefix is the prefix shared by all of your applications environment variables.
+         */
+        CommandLineInterfaceBuilder& WithEnvironment( const QString& prefix );
+
+        /**
+         * @brief WithConfigFileWatching will watch your configuration files and re-apply their values when they change.
+         * This is intended for long running services which want to pick up new settings without being restarted.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("rate-limit", "100", "Requests per second.",
+         *                                          [&limiter](QVariant limit) {
+         *                                                limiter.setRate( limit.toInt() );
+         *                                          })
+         *                                  .WithConfigFile("/etc/mycoolapp.ini")
+         *                                  .WithConfigFileWatching();
+         * @endcode
+         *
+         * When a configuration file changes only the configuration files are re-read, arguments which were provided on the
+         * command line or through the environment are left alone. The action handlers of the arguments whose value actually
+         * changed are executed once the new values have been applied. An argument which is removed from the configuration
+         * files goes back to its default value.
+         *
+         * Watching requires a running event loop. See CommandLineInterface::reloadConfiguration() to trigger a reload yourself.
+         */
+        CommandLineInterfaceBuilder& WithConfigFileWatching();
+
+        /**
+         * @brief WithDeferredActions will hold back all action handlers until the whole command line has been processed.
+         * By default an action handler is executed as soon as its arguments value is applied. With deferred actions every
+         * argument is parsed and every value is stored first, then the action handlers are executed in one batch ordered
+         * by their priority (see WithPriority). Use this when your handlers open files or sockets and you don't want that
+         * work done for a command line which turns out to be wrong.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("log", "The log file.", [&logger](QVariant path) { logger.open( path.toString() ); })
+         *                                  .WithValue("server", "The server IP address.", [&client](QVariant ip) { client.connect( ip.toString() ); })
+         *                                  .WithPriority("log", 10)
+         *                                  .WithDeferredActions();
+         * @endcode
+         *
+         * In the above the log is always opened before connecting to the server no matter the order the user provided them in.
+         */
+        CommandLineInterfaceBuilder& WithDeferredActions();
+
+        /**
+         * @brief WithLazyParsing will put off processing the command line until a value is first read.
+         * Only a quick scan of the option names is done when the CommandLineInterface is built, if it finds an action,
+         * such as help or version, or an argument with an action handler or bound variable, the command line is processed
+         * straight away as usual. Otherwise the command line is processed the first time a value or positional input is
+         * read and never again after that.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("server", "The server IP address.")
+         *                                  .WithFlag("verbose", "Log everything.")
+         *                                  .WithLazyParsing();
+         * @endcode
+         *
+         * Use this for short lived helper processes which only read a few of their options on the common path. Building
+         * with configuration files, an environment prefix, statistics or constraints always processes the command line
+         * straight away, as does giving a choice argument or an argument with validators, so a bad command line is still
+         * reported when the CommandLineInterface is built.
+         */
+        CommandLineInterfaceBuilder& WithLazyParsing();
+
+        /**
+         * @brief WithInterpolation lets values reference other arguments and environment variables as <i>${name}</i>.
+         * A placeholder names an argument, or an environment variable if there is no argument with that name, use <i>$${</i>
+         * for a literal <i>${</i>. Placeholders are expanded when the value is read through the index operator or a subtree,
+         * values the placeholders reference are expanded first and each expanded value is kept until a value changes. Defaults
+         * and values from configuration files are expanded the same as values from the command line. Variables bound to an
+         * argument are written with the expanded text once the command line has been processed.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("data-dir", "/var/lib/mycoolapp", "Where to keep data.")
+         *                                  .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.")
+         *                                  .WithInterpolation();
+         * @endcode
+         *
+         * Running the above with <i>--data-dir=/tmp</i> gives a log-dir of /tmp/logs. Reading a value which references itself,
+         * directly or through other values, throws an InterpolationCycleException.
+         */
+        CommandLineInterfaceBuilder& WithInterpolation();
+
+        /**
+         * @brief WithSerializedValues takes the values from a parent process instead of processing the command line.
+         * The parent writes CommandLineInterface::serializedValues() to a pipe or file the child inherits. The child's command
+         * line, configuration files and environment are not looked at, its values are exactly those of the parent. Call this
+         * before adding commands so the parent's commands are selected, the arguments must match the parent's.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithSerializedValues( 3 )
+         *                                  .WithValue("workers", "4", "How many workers to start.");
+         * @endcode
+         *
+         * @param values are the values written by the parent. If they were written by an incompatible version of Taranis they
+         * are ignored and the command line is processed as usual.
+         */
+        CommandLineInterfaceBuilder& WithSerializedValues( const QByteArray& values );
+
+        /**
+         * @brief WithSerializedValues reads the values from a file descriptor inherited from the parent process.
+         * @param fileDescriptor is read to the end, it is not closed.
+         * @see WithSerializedValues(const QByteArray&)
+         */
+        CommandLineInterfaceBuilder& WithSerializedValues( int fileDescriptor );
+
+        /**
+         * @brief WithPriority sets the priority of an arguments action handler when actions are deferred.
+         * Handlers with a higher priority are executed first, handlers with the same priority are executed in the order their
+         * values were applied. The default priority is 0.
+         *
+         * @param name is the name of an argument which has already been added.
+         * @param priority is the priority of the arguments action handler.
+         */
+        CommandLineInterfaceBuilder& WithPriority( const QString& name, int priority );
+
+        /**
+         * @brief WithAsyncActions will execute the action handlers on a thread pool so slow handlers run concurrently.
+         * This implies WithDeferredActions(), the handlers are started once the whole command line has been processed.
+         * Handlers which don't depend on each other run at the same time, use WithDependency to make a handler wait
+         * for another. Processing the command line does not wait for the handlers, use CommandLineInterface::actionsFinished()
+         * to find out when they are done.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithAction("warm-cache", "Warms the cache.", [&cache](QVariant) { cache.warm(); })
+         *                                  .WithValue("model", "The model to load.", [&engine](QVariant path) { engine.load( path.toString() ); })
+         *                                  .WithValue("database", "The database to connect to.", [&pool](QVariant url) { pool.open( url.toString() ); })
+         *                                  .WithDependency("warm-cache", "database")
+         *                                  .WithAsyncActions();
+         *
+         * cli.actionsFinished().waitForFinished();
+         * @endcode
+         *
+         * In the above the model is loaded while the database pool opens, and the cache is warmed once the pool is open.
+         *
+         * @warning Your handlers are executed on other threads so they must be thread safe and must not throw.
+         *
+         * @param pool is the thread pool to execute the handlers on, if none is given the global thread pool is used.
+         */
+        CommandLineInterfaceBuilder& WithAsyncActions( QThreadPool* pool = nullptr );
+
+        /**
+         * @brief WithDependency makes the action handler of one argument wait for the action handler of another when actions are deferred.
+         * If the argument depended on was not provided there is nothing to wait for. Priorities only decide between the handlers
+         * which are ready to go.
+         *
+         * @param name is the name of the argument whose handler has to wait.
+         * @param dependency is the name of the argument whose handler has to finish first.
+         * @throws CircularDependencyException if the dependency would form a loop.
+         */
+        CommandLineInterfaceBuilder& WithDependency( const QString& name, const QString& dependency );
+
+        /**
+         * @brief WithRequired makes an argument mandatory, the command line must include it.
+         * Every rule about which arguments go together is checked once the command line has been read and before any
+         * value is applied. If any rule is broken a ConstraintViolationException listing all of them is thrown. An argument
+         * given a value by a configuration file or the environment counts as present the same as one on the command line,
+         * defaults don't. Nothing is checked when the user asks for help or the version.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("input", "The file to read.")
+         *                                  .WithValue("output", "The file to write.")
+         *                                  .WithFlag("json", "Write JSON.")
+         *                                  .WithFlag("xml", "Write XML.")
+         *                                  .WithRequired("input")
+         *                                  .WithExclusive({"json", "xml"})
+         *                                  .WithRequires("json", "output");
+         * @endcode
+         *
+         * @param name is the name of the argument, which must already be added.
+         */
+        CommandLineInterfaceBuilder& WithRequired( const QString& name );
+
+        /**
+         * @brief WithRequires makes one argument need another, if the first is given the second must be as well.
+         * @param name is the name of the argument which needs the other.
+         * @param requirement is the name of the argument it needs.
+         * @see WithRequired()
+         */
+        CommandLineInterfaceBuilder& WithRequires( const QString& name, const QString& requirement );
+
+        /**
+         * @brief WithExclusive makes a group of arguments mutually exclusive, at most one of them can be given.
+         * @param names are the names of the arguments in the group.
+         * @see WithRequired()
+         */
+        CommandLineInterfaceBuilder& WithExclusive( const QStringList& names );
+
+        /**
+         * @brief WithAtLeastOne makes a group of arguments where at least one of them must be given.
+         * @param names are the names of the arguments in the group.
+         * @see WithRequired()
+         */
+        CommandLineInterfaceBuilder& WithAtLeastOne( const QStringList& names );
+
+        /**
+         * @brief WithRange makes sure the value of an argument is a number within a range.
+         * Validators are checked once the command line has been read and before any value is applied, values from
+         * configuration files and the environment are checked too. If any value fails a ValidationException listing
+         * all of the failures is thrown. An argument can have more than one validator.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("port", "The port to listen on.")
+         *                                  .WithRange("port", 1, 65535);
+         * @endcode
+         *
+         * @param name is the name of the argument, which must already be added.
+         * @param minimum is the lowest value allowed.
+         * @param maximum is the highest value allowed.
+         */
+        CommandLineInterfaceBuilder& WithRange( const QString& name, double minimum, double maximum );
+
+        /**
+         * @brief WithPattern makes sure the whole value of an argument matches a regular expression.
+         * The pattern is compiled and optimized once when the argument is added, arguments with the same pattern share it.
+         * @param pattern is a Perl compatible regular expression, see QRegularExpression.
+         * @see WithRange()
+         */
+        CommandLineInterfaceBuilder& WithPattern( const QString& name, const QString& pattern );
+
+        /**
+         * @brief WithExistingFile makes sure the value of an argument is the path of a file which exists.
+         * Checking the file system is slow so these checks are run on a thread pool, the one given to WithAsyncActions()
+         * or the global pool.
+         * @see WithRange()
+         */
+        CommandLineInterfaceBuilder& WithExistingFile( const QString& name );
+
+        /**
+         * @brief WithExistingDirectory makes sure the value of an argument is the path of a directory which exists.
+         * @see WithExistingFile()
+         */
+        CommandLineInterfaceBuilder& WithExistingDirectory( const QString& name );
+
+        /**
+         * @brief WithHostPort makes sure the value of an argument is a host and port, such as example.com:8080 or [::1]:8080.
+         * @see WithRange()
+         */
+        CommandLineInterfaceBuilder& WithHostPort( const QString& name );
+
+        /**
+         * @brief WithAlias gives an argument another name.
+         * The alias goes into the same look up as the arguments own names so using it costs nothing extra. Aliases are not
+         * listed in the help.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithFlag("silent", "Print nothing.")
+         *                                  .WithAlias("quiet", "silent");
+         * @endcode
+         *
+         * @param alias is the other name, example 'quiet'.
+         * @param name is the name of the argument, which must already be added.
+         * @throws ArgumentRedefinitionException if the alias is already used by another argument or a preset.
+         */
+        CommandLineInterfaceBuilder& WithAlias( const QString& alias, const QString& name );
+
+        /**
+         * @brief WithDeprecated keeps an old name of an argument working, the first time it is used a warning points to the new name.
+         * @param deprecatedName is the old name of the argument.
+         * @param name is the name of the argument it was renamed to, which must already be added.
+         * @see WithAlias()
+         */
+        CommandLineInterfaceBuilder& WithDeprecated( const QString& deprecatedName, const QString& name );
+
+        /**
+         * @brief WithPreset adds an option which stands for a list of options.
+         * The options are lexed once when the preset is added and spliced in wherever the preset is used, options which come
+         * after the preset override the values it gives. A preset may name presets added before it. Presets are listed in the help.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("log-level", "info", "How much to log.")
+         *                                  .WithValue("workers", "4", "How many workers to start.")
+         *                                  .WithPreset("prod", {"--log-level=warn", "--workers", "64"});
+         * @endcode
+         *
+         * @param name is the name of the preset, example 'prod'.
+         * @param options are the options it stands for as they would be typed, a value may be in the same or the next item.
+         * @throws ArgumentRedefinitionException if the name is already used by an argument or a preset.
+         */
+        CommandLineInterfaceBuilder& WithPreset( const QString& name, const QStringList& options );
+
+        /**
+         * @brief WithStatistics will record how long building and processing your command line interface takes.
+         * The wall time of each phase (registration, tokenization, look ups, configuration, action handlers, and help)
+         * is available through CommandLineInterface::statistics(). If Taranis was built with
+         * <i>CONFIG += taranis_count_allocations</i> the heap allocations made in each phase are counted as well, see
+         * ParseStatistics for which allocations are seen on each platform.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithFlag("force", "Will force a refresh.")
+         *                                  .WithStatistics("/tmp/mycoolapp-trace.json");
+         * @endcode
+         *
+         * This also adds a hidden <i>--taranis-stats</i> argument which prints the statistics as JSON to stderr once the
+         * command line has been processed, letting you see how much of your start up is spent in Taranis.
+         *
+         * @code{.unparsed}
+         * $ mycoolapp --taranis-stats
+         * {"allocationCounting":false,"phases":{"callbacks":{"allocations":0,"bytes":0,"count":1,"nanoseconds":1200},...}}
+         * @endcode
+         *
+         * @param traceFile is an optional file to write the phases to in the Chrome trace event format, open it in chrome://tracing or Perfetto.
+         */
+        CommandLineInterfaceBuilder& WithStatistics( const QString& traceFile = QString() );
+
+        /**
+         * @brief WithSchemaCache will store the arguments registered by the given function in a binary cache file and
+         * use that file in place of calling the function the next time your application starts.
+         * This is meant for interfaces generated at runtime, such as from plugin manifests, with a great many arguments.
+         * Loading the cache skips registering and validating the arguments one by one.
+         *
+         * @code{.cpp}
+         * QByteArray manifestHash = QCryptographicHash::hash( manifest, QCryptographicHash::Sha1 );
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithSchemaCache( cachePath, manifestHash, [&plugins](CommandLineInterfaceBuilder& builder) {
+         *                                        foreach( Plugin plugin, plugins ) {
+         *                                            builder.WithValue( plugin.option(), plugin.defaultValue(), plugin.description() );
+         *                                        }
+         *                                  });
+         * @endcode
+         *
+         * The cache is rebuilt when the manifest hash changes, when it was written by another version of Taranis or when
+         * any of its names are already taken by arguments registered outside of it. Only plain flags, values, actions
+         * and positional arguments can be cached. If the function registers an argument with an action handler, bound
+         * variable or dependency, or gives an alias to an argument registered outside of it, nothing is written and the
+         * function is called every time.
+         *
+         * @param path is where to keep the cache file.
+         * @param manifestHash is a hash of whatever the arguments are generated from.
+         * @param registration is the function which registers the arguments to be cached.
+         */
+        CommandLineInterfaceBuilder& WithSchemaCache( const QString& path, const QByteArray& manifestHash, std::function<void(CommandLineInterfaceBuilder&)> registration );
+
+        /**
+         * @brief WithNamespace will register the arguments under a dotted namespace only once they are needed.
+         * The loader is called the first time an input under the namespace is on the command line, such as <i>--auth.ldap.url</i>
+         * for the <i>auth</i> namespace, or a value under it is read. Use this for plugins which contribute many options so
+         * a plugin nobody passes options to is never loaded.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithNamespace("auth", [](CommandLineInterfaceBuilder& builder) {
+         *                                        AuthPlugin::load();
+         *                                        builder.WithValue("auth.ldap.url", "The LDAP server.")
+         *                                               .WithFlag("auth.ldap.tls", "Use TLS for LDAP.");
+         *                                  });
+         * @endcode
+         *
+         * The loader registers arguments with their full dotted names, dotted names never get a short name. Namespaces
+         * can be nested, every loader along the path is called outer namespace first. Rendering the help text, listing the
+         * arguments or reading configuration files or the environment needs every argument so all namespaces are loaded then.
+         *
+         * @param name is the dotted path of the namespace.
+         * @param loader is the function which registers the arguments of the namespace.
+         */
+        CommandLineInterfaceBuilder& WithNamespace( const QString& name, std::function<void(CommandLineInterfaceBuilder&)> loader );
+
+        /**
+         * @brief WithCompletion gives an argument a provider of the values tab completion offers for it.
+         * The provider is handed what has been typed of the value so far and returns the values it could become, values
+         * which don't start with what was typed are left out. It is only called while answering a completion request.
+         *
+         * @code{.cpp}
+         * CommandLineInterface cli = CommandLineInterface::build()
+         *                                  .WithValue("profile", "The profile to use.")
+         *                                  .WithCompletion("profile", [](QString partial) {
+         *                                        return ProfileStore::names();
+         *                                  });
+         * @endcode
+         *
+         * @param name is the name of the argument, which must already be added.
+         * @param provider returns the values which could complete the given partial value.
+         * @see CommandLineInterface::completionScript()
+         */
+        CommandLineInterfaceBuilder& WithCompletion( const QString& name, std::function<QStringList(QString)> provider );
+
 
     protected:
         explicit CommandLineInterfaceBuilder(const QString applicationName, QStringList arguments);
@@ -333,6 +968,25 @@ namespace Taranis
 
     private:
         CommandLineInterface* m_cli;
+        bool m_ownsInterface;
+
+        /**
+         * @brief CommandLineInterfaceBuilder creates a builder which adds to an existing interface without taking ownership of it.
+         * This is what namespace loaders are handed when they run after the interface has been built.
+         */
+        explicit CommandLineInterfaceBuilder(CommandLineInterface* cli);
+
+        /**
+         * @brief isAnsweringVersion tells if the only input is a request for the built in version action.
+         * Arguments are then not created since the process exits before any of them could be read.
+         */
+        bool isAnsweringVersion() const;
+
+        /**
+         * @brief isCompleting tells if the application was run by the shell to complete a word.
+         * Only the names of the arguments are needed then, nothing is read from configuration files or the environment.
+         */
+        bool isCompleting() const;
     };
 }
 
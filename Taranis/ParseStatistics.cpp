@@ -0,0 +1,191 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include "ParseStatistics.hpp"
+#include "AllocationCounter.hpp"
+
+using namespace Taranis;
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ParseStatistics::ParseStatistics(const QElapsedTimer& clock) :
+    m_clock( clock )
+{
+    if ( !m_clock.isValid() ) m_clock.start();
+
+    for ( int i = 0; i < PhaseCount; ++i )
+    {
+        m_totals[i] = Totals{ 0, 0, 0, 0 };
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ParseStatistics::ParseStatistics(const ParseStatistics& other)
+{
+    *this = other;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ParseStatistics& ParseStatistics::operator=(const ParseStatistics& other)
+{
+    if ( this == &other ) return *this;
+
+    QMutexLocker locker( &other.m_lock );
+    m_clock = other.m_clock;
+    for ( int i = 0; i < PhaseCount; ++i )
+    {
+        m_totals[i] = other.m_totals[i];
+    }
+    m_events = other.m_events;
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ParseStatistics::count(Phase phase) const
+{
+    QMutexLocker locker( &m_lock );
+    return m_totals[phase].count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+qint64 ParseStatistics::elapsed(Phase phase) const
+{
+    QMutexLocker locker( &m_lock );
+    return m_totals[phase].nanoseconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 ParseStatistics::allocations(Phase phase) const
+{
+    QMutexLocker locker( &m_lock );
+    return m_totals[phase].allocations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 ParseStatistics::allocatedBytes(Phase phase) const
+{
+    QMutexLocker locker( &m_lock );
+    return m_totals[phase].bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ParseStatistics::isCountingAllocations()
+{
+    return AllocationCounter::isEnabled();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ParseStatistics::phaseName(Phase phase)
+{
+    switch ( phase )
+    {
+    case Registration:
+        return QStringLiteral("registration");
+    case Tokenization:
+        return QStringLiteral("tokenization");
+    case Lookup:
+        return QStringLiteral("lookup");
+    case Configuration:
+        return QStringLiteral("configuration");
+    case Callbacks:
+        return QStringLiteral("callbacks");
+    case Help:
+        return QStringLiteral("help");
+    default:
+        return QString();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QByteArray ParseStatistics::toJson() const
+{
+    QMutexLocker locker( &m_lock );
+
+    QJsonObject phases;
+    for ( int i = 0; i < PhaseCount; ++i )
+    {
+        QJsonObject totals;
+        totals["count"] = m_totals[i].count;
+        totals["nanoseconds"] = static_cast<double>( m_totals[i].nanoseconds );
+        totals["allocations"] = static_cast<double>( m_totals[i].allocations );
+        totals["bytes"] = static_cast<double>( m_totals[i].bytes );
+        phases[phaseName( static_cast<Phase>( i ) )] = totals;
+    }
+
+    QJsonObject root;
+    root["allocationCounting"] = AllocationCounter::isEnabled();
+    root["phases"] = phases;
+    return QJsonDocument( root ).toJson( QJsonDocument::Compact );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QByteArray ParseStatistics::toChromeTrace() const
+{
+    QMutexLocker locker( &m_lock );
+
+    QJsonArray events;
+    foreach( const Event& event, m_events )
+    {
+        QJsonObject traceEvent;
+        traceEvent["name"] = phaseName( event.phase );
+        traceEvent["cat"] = QStringLiteral("taranis");
+        traceEvent["ph"] = QStringLiteral("X");
+        traceEvent["ts"] = event.start / 1000.0;
+        traceEvent["dur"] = event.duration / 1000.0;
+        traceEvent["pid"] = 1;
+        traceEvent["tid"] = 1;
+        events.append( traceEvent );
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = QStringLiteral("ns");
+    return QJsonDocument( root ).toJson( QJsonDocument::Compact );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ParseStatistics::record(Phase phase, qint64 start, qint64 duration, quint64 allocations, quint64 bytes)
+{
+    QMutexLocker locker( &m_lock );
+
+    Totals& totals = m_totals[phase];
+    ++totals.count;
+    totals.nanoseconds += duration;
+    totals.allocations += allocations;
+    totals.bytes += bytes;
+
+    if ( phase != Lookup )
+    {
+        m_events.append( Event{ phase, start, duration } );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+qint64 ParseStatistics::now() const
+{
+    return m_clock.nsecsElapsed();
+}
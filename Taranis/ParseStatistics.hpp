@@ -0,0 +1,125 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PARSESTATISTICS_HPP
+#define PARSESTATISTICS_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class PhaseTimer;
+    }
+
+    /**
+     * @brief The ParseStatistics class records where the time goes while your command line interface is built and processed.
+     * For each phase it records how often the phase ran, the wall time spent in it, and, if Taranis was built with
+     * <i>CONFIG += taranis_count_allocations</i>, the number of heap allocations and bytes allocated. On glibc every
+     * malloc, calloc and realloc is counted, which includes the storage of the Qt strings and containers. On other
+     * platforms only operator new is counted, so most of what Qt allocates is missing from the numbers.
+     *
+     * Statistics are only recorded if the interface was built with CommandLineInterfaceBuilder::WithStatistics().
+     *
+     * @code{.cpp}
+     * CommandLineInterface cli = CommandLineInterface::build().WithFlag("force", "Will force a refresh.").WithStatistics();
+     * qDebug() << cli.statistics().elapsed( ParseStatistics::Tokenization );
+     * @endcode
+     */
+    class ParseStatistics
+    {
+        friend class Internal::PhaseTimer;
+    public:
+        enum Phase {
+            Registration,   //< From constructing the builder until the command line is processed.
+            Tokenization,   //< Scanning the inputs, including the argument look ups.
+            Lookup,         //< Looking up the arguments named on the command line.
+            Configuration,  //< Reading the environment and configuration files.
+            Callbacks,      //< Executing the action handlers.
+            Help,           //< Rendering the help message.
+            PhaseCount
+        };
+
+        explicit ParseStatistics( const QElapsedTimer& clock = QElapsedTimer() );
+        ParseStatistics( const ParseStatistics& other );
+        ParseStatistics& operator=( const ParseStatistics& other );
+
+        int count( Phase phase ) const;
+
+        /**
+         * @return Returns the wall time spent in the phase in nanoseconds.
+         */
+        qint64 elapsed( Phase phase ) const;
+        quint64 allocations( Phase phase ) const;
+        quint64 allocatedBytes( Phase phase ) const;
+
+        /**
+         * @return Returns true if Taranis was built to count allocations.
+         */
+        static bool isCountingAllocations();
+        static QString phaseName( Phase phase );
+
+        /**
+         * @brief toJson renders the totals of every phase as a JSON object keyed by phase name.
+         */
+        QByteArray toJson() const;
+
+        /**
+         * @brief toChromeTrace renders each phase as a complete event in the Chrome trace event format.
+         * Load the output in chrome://tracing or Perfetto. Look ups happen once per input so they are only
+         * included in the totals, not as events.
+         */
+        QByteArray toChromeTrace() const;
+
+    private:
+        struct Totals
+        {
+            int count;
+            qint64 nanoseconds;
+            quint64 allocations;
+            quint64 bytes;
+        };
+
+        struct Event
+        {
+            Phase phase;
+            qint64 start;
+            qint64 duration;
+        };
+
+        mutable QMutex m_lock;
+        QElapsedTimer m_clock;
+        Totals m_totals[PhaseCount];
+        QVector<Event> m_events;
+
+        void record( Phase phase, qint64 start, qint64 duration, quint64 allocations, quint64 bytes );
+        qint64 now() const;
+    };
+}
+
+#endif // PARSESTATISTICS_HPP
@@ -0,0 +1,254 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QFile>
+#include <QBuffer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QMetaType>
+#include <cstdio>
+#include <limits>
+#include "Payload.hpp"
+
+using namespace Taranis;
+
+/**
+ * @brief The Payload::Content class is what the copies of a payload share, it holds the mapping until the last copy is gone.
+ */
+class Payload::Content
+{
+public:
+    Source source;
+    QString text;
+    QMutex lock;
+    QFile file;
+    bool loaded;
+    QByteArray bytes;
+    QScopedPointer<QIODevice> device;
+    QString error;
+
+    Content() :
+        source( Inline ),
+        loaded( false )
+    {}
+};
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void registerComparator()
+    {
+        // Without it QVariant compares payloads by address, so a reloaded configuration would always see them as changed.
+        static const bool registered = QMetaType::registerEqualsComparator<Payload>();
+        Q_UNUSED( registered );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+Payload::Payload() :
+    m_content( new Content() )
+{
+    registerComparator();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+Payload::Payload(const QString& value) :
+    m_content( new Content() )
+{
+    registerComparator();
+    if ( value == QStringLiteral("-") )
+    {
+        m_content->source = StandardInput;
+    }
+    else if ( value.startsWith( QStringLiteral("@@") ) )
+    {
+        m_content->text = value.mid( 1 );
+    }
+    else if ( value.startsWith( QChar('@') ) )
+    {
+        m_content->source = File;
+        m_content->text = value.mid( 1 );
+    }
+    else
+    {
+        m_content->text = value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+Payload::Source Payload::source() const
+{
+    return m_content->source;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString Payload::path() const
+{
+    return ( m_content->source == File ) ? m_content->text : QString();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QByteArray Payload::data() const
+{
+    Content& content = *m_content;
+    QMutexLocker locker( &content.lock );
+    if ( content.loaded ) return content.bytes;
+    content.loaded = true;
+
+    switch ( content.source )
+    {
+    case Inline:
+        content.bytes = content.text.toUtf8();
+        break;
+    case File:
+    {
+        content.file.setFileName( content.text );
+        if ( !content.file.open( QIODevice::ReadOnly ) )
+        {
+            content.error = content.file.errorString();
+            break;
+        }
+
+        // Same as the configuration files, hand out the mapping itself and fall back to reading the file in.
+        // The file stays open so the mapping lives as long as the content does.
+        qint64 size = content.file.size();
+
+        // A QByteArray can't hold more than an int's worth of bytes, bigger files can only be streamed through device().
+        if ( size > std::numeric_limits<int>::max() )
+        {
+            content.error = QString("The file {%1} is too large to load, read it through device() instead.").arg( content.text );
+            content.file.close();
+            break;
+        }
+
+        const char* mapping = ( size > 0 ) ? reinterpret_cast<const char*>( content.file.map( 0, size ) ) : nullptr;
+        if ( mapping != nullptr )
+        {
+            content.bytes = QByteArray::fromRawData( mapping, int( size ) );
+        }
+        else
+        {
+            content.bytes = content.file.readAll();
+        }
+        break;
+    }
+    case StandardInput:
+    {
+        QFile input;
+        if ( !input.open( stdin, QIODevice::ReadOnly ) )
+        {
+            content.error = input.errorString();
+            break;
+        }
+        content.bytes = input.readAll();
+        break;
+    }
+    }
+
+    return content.bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QIODevice* Payload::device() const
+{
+    // The inline text is the only payload already in memory, for files and stdin the device
+    // reads as it goes so a consumer which streams never holds the whole payload.
+    if ( m_content->source == Inline ) data();
+
+    Content& content = *m_content;
+    QMutexLocker locker( &content.lock );
+    if ( !content.device.isNull() ) return content.device.data();
+
+    // Stdin can only be read once, if data() already read it the device reads that copy.
+    Source source = ( ( content.source == StandardInput ) && content.loaded ) ? Inline : content.source;
+    switch ( source )
+    {
+    case Inline:
+    {
+        QBuffer* buffer = new QBuffer();
+        buffer->setData( content.bytes );
+        content.device.reset( buffer );
+        break;
+    }
+    case File:
+        content.device.reset( new QFile( content.text ) );
+        break;
+    case StandardInput:
+    {
+        QFile* input = new QFile();
+        content.device.reset( input );
+        if ( !input->open( stdin, QIODevice::ReadOnly ) )
+        {
+            content.error = input->errorString();
+            content.device.reset();
+            return nullptr;
+        }
+        return input;
+    }
+    }
+
+    if ( !content.device->isOpen() && !content.device->open( QIODevice::ReadOnly ) )
+    {
+        content.error = content.device->errorString();
+        content.device.reset();
+        return nullptr;
+    }
+    return content.device.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString Payload::errorString() const
+{
+    QMutexLocker locker( &m_content->lock );
+    return m_content->error;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString Payload::toString() const
+{
+    switch ( m_content->source )
+    {
+    case File:
+        return QStringLiteral("@") + m_content->text;
+    case StandardInput:
+        return QStringLiteral("-");
+    default:
+        return m_content->text.startsWith( QChar('@') ) ? QStringLiteral("@") + m_content->text : m_content->text;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Payload::operator==(const Payload& other) const
+{
+    if ( m_content == other.m_content ) return true;
+    if ( m_content->source != other.m_content->source ) return false;
+    if ( m_content->source == StandardInput ) return true;
+    return data() == other.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Payload::operator!=(const Payload& other) const
+{
+    return !( *this == other );
+}
@@ -0,0 +1,106 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PAYLOAD_HPP
+#define PAYLOAD_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QMetaType>
+
+class QIODevice;
+
+namespace Taranis
+{
+    /**
+     * @brief The Payload class is the value of an argument which takes a large payload, such as a policy document or certificate bundle.
+     * The value given on the command line can be the payload itself, <i>@path</i> to read it from a file or <i>-</i> to read it
+     * from stdin. Use <i>@@</i> for a payload which starts with an @. Nothing is read while the command line is processed, a
+     * file is memory mapped the first time its data is asked for and the data is handed out without copying the mapping.
+     *
+     * Copies share the same mapping which stays valid for as long as any copy of the payload exists.
+     *
+     * @code{.cpp}
+     * Payload policy = cli["policy"].value<Payload>();
+     * QJsonDocument document = QJsonDocument::fromJson( policy.data() );
+     * @endcode
+     */
+    class Payload
+    {
+    public:
+        enum Source
+        {
+            Inline,         //< The payload was given on the command line.
+            File,           //< The payload is the contents of a file, given as @path.
+            StandardInput   //< The payload is read from stdin, given as -.
+        };
+
+        Payload();
+        explicit Payload(const QString& value);
+
+        Source source() const;
+
+        /**
+         * @brief path is the file the payload comes from, empty unless the source is a file.
+         */
+        QString path() const;
+
+        /**
+         * @brief data returns the payload, mapping the file or reading stdin the first time it is called.
+         * The returned array does not own its memory when the file could be mapped, it must not outlive this payload.
+         * Files of 2 GiB or more don't fit in a QByteArray, read those through device().
+         * @return Returns the payload or an empty array if it could not be read, see errorString().
+         */
+        QByteArray data() const;
+
+        /**
+         * @brief device opens the payload for reading as a stream, which for stdin avoids holding the whole payload in memory.
+         * The device is owned by the payload and is opened on the first call, later calls return the same device. Stdin can
+         * only be read once so a payload from stdin should be read either through data() or through the device.
+         * @return Returns the device or nullptr if it could not be opened, see errorString().
+         */
+        QIODevice* device() const;
+        QString errorString() const;
+
+        /**
+         * @brief toString gives the value the payload was made from, as it would be typed on the command line.
+         */
+        QString toString() const;
+
+        /**
+         * @brief Two payloads are equal when they come from the same kind of source and hold the same content, the files
+         * are read to compare them. Payloads from stdin are never read for this, any two of them are equal.
+         */
+        bool operator==(const Payload& other) const;
+        bool operator!=(const Payload& other) const;
+
+    private:
+        class Content;
+        QSharedPointer<Content> m_content;
+    };
+}
+
+Q_DECLARE_METATYPE(Taranis::Payload)
+
+#endif // PAYLOAD_HPP
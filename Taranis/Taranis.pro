@@ -10,23 +10,71 @@ DEFINES += TARANIS_LIBRARY
 
 INCLUDEPATH += internal
 
+# Replaces the global operator new so ParseStatistics can report allocations.
+taranis_count_allocations {
+    DEFINES += TARANIS_COUNT_ALLOCATIONS
+}
+
+# Instruments the library for coverage guided fuzzing, see TaranisFuzz.
+taranis_libfuzzer {
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer-no-link,address
+}
+
 SOURCES += \
     CommandLineInterface.cpp \
     CommandLineInterfaceBuilder.cpp \
+    ArgumentSpan.cpp \
+    ArgumentSubtree.cpp \
+    Payload.cpp \
+    ParseStatistics.cpp \
     TaranisExceptions.cpp \
     internal/InputArgument.cpp \
     internal/Argument.cpp \
-    internal/InputArgumentKeyValuePair.cpp
+    internal/ArgumentBinding.cpp \
+    internal/InputArgumentKeyValuePair.cpp \
+    internal/ConfigurationFile.cpp \
+    internal/ConfigurationWatcher.cpp \
+    internal/ValueStore.cpp \
+    internal/ActionScheduler.cpp \
+    internal/AllocationCounter.cpp \
+    internal/PhaseTimer.cpp \
+    internal/SchemaCache.cpp \
+    internal/NamespaceTrie.cpp \
+    internal/ChoiceTable.cpp \
+    internal/ConstraintSet.cpp \
+    internal/ArgumentValidator.cpp \
+    internal/ValidationBatch.cpp \
+    internal/PresetTable.cpp \
+    internal/Interpolator.cpp
 
 HEADERS += \
     taranis_global.hpp \
     CommandLineInterface.hpp \
     CommandLineInterfaceBuilder.hpp \
+    ArgumentSpan.hpp \
+    ArgumentSubtree.hpp \
+    Payload.hpp \
+    ParseStatistics.hpp \
     TaranisExceptions.hpp \
     internal/InputArgument.hpp \
     internal/Argument.hpp \
+    internal/ArgumentBinding.hpp \
     internal/ArgumentType.hpp \
-    internal/InputArgumentKeyValuePair.hpp
+    internal/InputArgumentKeyValuePair.hpp \
+    internal/ConfigurationFile.hpp \
+    internal/ConfigurationWatcher.hpp \
+    internal/ValueStore.hpp \
+    internal/ActionScheduler.hpp \
+    internal/AllocationCounter.hpp \
+    internal/PhaseTimer.hpp \
+    internal/SchemaCache.hpp \
+    internal/NamespaceTrie.hpp \
+    internal/ChoiceTable.hpp \
+    internal/ConstraintSet.hpp \
+    internal/ArgumentValidator.hpp \
+    internal/ValidationBatch.hpp \
+    internal/PresetTable.hpp \
+    internal/Interpolator.hpp
 
 unix {
     target.path = /usr/lib
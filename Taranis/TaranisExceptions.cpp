@@ -82,3 +82,60 @@ VersionShortNameCollisionException::VersionShortNameCollisionException(const QSt
 VersionArgumentRedefinitionException::VersionArgumentRedefinitionException() :
     ArgumentRedefinitionException("version")
 {}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+PositionalListRedefinitionException::PositionalListRedefinitionException(const QString &argName) :
+    TaranisException(QString("Only one positional list can be defined, {%1} would be the second.").arg(argName))
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+CircularDependencyException::CircularDependencyException(const QString &argName, const QString &dependencyName) :
+    TaranisException(QString("The argument {%1} can not depend on {%2} because {%2} already depends on {%1}.").arg(argName).arg(dependencyName))
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+InvalidChoiceException::InvalidChoiceException(const QString &argName, const QString &value, const QStringList &choices) :
+    TaranisException(QString("The value {%1} is not a choice of the argument {%2}, expected one of {%3}.").arg(value, argName, choices.join(", ")))
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+ConstraintViolationException::ConstraintViolationException(const QStringList &violations) :
+    TaranisException(violations.join("\n")),
+    m_violations( violations )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ConstraintViolationException::violations() const
+{
+    return m_violations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValidationException::ValidationException(const QStringList &failures) :
+    TaranisException(failures.join("\n")),
+    m_failures( failures )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ValidationException::failures() const
+{
+    return m_failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+InterpolationCycleException::InterpolationCycleException(const QStringList &cycle) :
+    TaranisException(QString("The values of the arguments {%1} reference each other.").arg(cycle.join(" -> "))),
+    m_cycle( cycle )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList InterpolationCycleException::cycle() const
+{
+    return m_cycle;
+}
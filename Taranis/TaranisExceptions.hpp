@@ -26,6 +26,7 @@
 
 #include <QtGlobal>
 #include <QString>
+#include <QStringList>
 #include <exception>
 
 namespace Taranis
@@ -191,6 +192,149 @@ namespace Taranis
             virtual ~VersionShortNameCollisionException() throw() {}
 
         };
+
+        /**
+         * @brief The PositionalListRedefinitionException class is an exception which occures when more then one positional list is defined.
+         * A positional list collects all the remaining positional inputs so there is no way to tell where one list would end and the next begin.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithPositionalList("sources", "The files to compile.")
+         *              .WithPositionalList("headers", "The headers to include.");
+         * @endcode
+         *
+         * The above would generate this exception becuase two positional lists have been defined.
+         *
+         * @param argName is the name of the second positional list.
+         */
+        class PositionalListRedefinitionException : public TaranisException
+        {
+        public:
+            PositionalListRedefinitionException(const QString& argName);
+            virtual ~PositionalListRedefinitionException() throw() {}
+        };
+
+        /**
+         * @brief The CircularDependencyException class is an exception which occures when the dependencies between action handlers form a loop.
+         * An action handler can't start until the handlers it depends on have finished, so a loop would mean none of them ever start.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithAction("cache", "Warms the cache.", warmCache)
+         *              .WithAction("model", "Loads the model.", loadModel)
+         *              .WithDependency("cache", "model")
+         *              .WithDependency("model", "cache");
+         * @endcode
+         *
+         * The above would generate this exception becuase <i>model</i> already depends on <i>cache</i>.
+         *
+         * @param argName is the name of the argument being given the dependency.
+         * @param dependencyName is the name of the argument it would depend on.
+         */
+        class CircularDependencyException : public TaranisException
+        {
+        public:
+            CircularDependencyException(const QString& argName, const QString& dependencyName);
+            virtual ~CircularDependencyException() throw() {}
+        };
+
+        /**
+         * @brief The InvalidChoiceException class is an exception which occures when a choice argument is given a value which is not one of its choices.
+         * The value is checked when the command line is processed, values from configuration files and the environment are checked too.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithChoice("log-level", {"debug", "info", "warn"}, "Sets how much is logged.");
+         * @endcode
+         *
+         * The above would generate this exception if it was run with <i>--log-level verbose</i>.
+         *
+         * @param argName is the name of the choice argument.
+         * @param value is the value which was given.
+         * @param choices are the values the argument accepts.
+         */
+        class InvalidChoiceException : public TaranisException
+        {
+        public:
+            InvalidChoiceException(const QString& argName, const QString& value, const QStringList& choices);
+            virtual ~InvalidChoiceException() throw() {}
+        };
+
+        /**
+         * @brief The ConstraintViolationException class is an exception which occures when the command line breaks the rules about which arguments go together.
+         * Every rule is checked before it is thrown so all of the problems with the command line are reported at once.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithFlag("json", "Output JSON.")
+         *              .WithFlag("xml", "Output XML.")
+         *              .WithExclusive({"json", "xml"});
+         * @endcode
+         *
+         * The above would generate this exception if it was run with <i>--json --xml</i>.
+         *
+         * @param violations describe each rule which was broken.
+         */
+        class ConstraintViolationException : public TaranisException
+        {
+        public:
+            ConstraintViolationException(const QStringList& violations);
+            virtual ~ConstraintViolationException() throw() {}
+            QStringList violations() const;
+
+        private:
+            QStringList m_violations;
+        };
+
+        /**
+         * @brief The ValidationException class is an exception which occures when values given to arguments fail their validators.
+         * Every value is checked before it is thrown so all of the invalid values are reported at once.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithValue("port", "The port to listen on.")
+         *              .WithRange("port", 1, 65535);
+         * @endcode
+         *
+         * The above would generate this exception if it was run with <i>--port 0</i>.
+         *
+         * @param failures describe each value which failed.
+         */
+        class ValidationException : public TaranisException
+        {
+        public:
+            ValidationException(const QStringList& failures);
+            virtual ~ValidationException() throw() {}
+            QStringList failures() const;
+
+        private:
+            QStringList m_failures;
+        };
+
+        /**
+         * @brief The InterpolationCycleException class is an exception which occures when values reference each other in a loop.
+         *
+         * @code{.cpp}
+         * CommandLineInterface::build()
+         *              .WithValue("data-dir", "${log-dir}/..", "Where to keep data.")
+         *              .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.")
+         *              .WithInterpolation();
+         * @endcode
+         *
+         * The above would generate this exception when either value is read.
+         *
+         * @param cycle are the names of the arguments in the loop, starting and ending with the same one.
+         */
+        class InterpolationCycleException : public TaranisException
+        {
+        public:
+            InterpolationCycleException(const QStringList& cycle);
+            virtual ~InterpolationCycleException() throw() {}
+            QStringList cycle() const;
+
+        private:
+            QStringList m_cycle;
+        };
     }
 }
 
@@ -0,0 +1,222 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QThreadPool>
+#include <QRunnable>
+#include <QException>
+#include <algorithm>
+#include "ActionScheduler.hpp"
+#include "Argument.hpp"
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The ActionTask class runs a single action of an ActionScheduler on a thread pool.
+         */
+        class ActionTask : public QRunnable
+        {
+        public:
+            ActionTask(QSharedPointer<ActionScheduler> scheduler, int index) :
+                m_scheduler( scheduler ),
+                m_index( index )
+            {
+                setAutoDelete( true );
+            }
+
+            void run() Q_DECL_OVERRIDE
+            {
+                m_scheduler->invoke( m_index );
+
+                foreach( int ready, m_scheduler->complete( m_index ) )
+                {
+                    m_scheduler->submit( ready );
+                }
+            }
+
+        private:
+            QSharedPointer<ActionScheduler> m_scheduler;
+            int m_index;
+        };
+    }
+}
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ActionScheduler::ActionScheduler(const QList< QPair<Argument*, QVariant> >& actions, QThreadPool* pool) :
+    m_pool( pool ),
+    m_remaining( actions.count() )
+{
+    m_nodes.reserve( actions.count() );
+    for ( const auto& action : actions )
+    {
+        Node node;
+        node.argument = action.first;
+        node.value = action.second;
+        node.waitingOn = 0;
+        m_nodes.append( node );
+    }
+
+    for ( int i = 0; i < m_nodes.count(); ++i )
+    {
+        foreach( Argument* dependency, m_nodes[i].argument->dependencies() )
+        {
+            for ( int j = 0; j < m_nodes.count(); ++j )
+            {
+                if ( ( i == j ) || ( m_nodes[j].argument != dependency ) ) continue;
+                ++m_nodes[i].waitingOn;
+                m_nodes[j].dependents.append( i );
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QFuture<void> ActionScheduler::start()
+{
+    m_finished.reportStarted();
+    QFuture<void> future = m_finished.future();
+
+    if ( m_nodes.isEmpty() )
+    {
+        m_finished.reportFinished();
+        return future;
+    }
+
+    QList<int> ready;
+    for ( int i = 0; i < m_nodes.count(); ++i )
+    {
+        if ( m_nodes[i].waitingOn == 0 ) ready.append( i );
+    }
+
+    if ( m_pool == nullptr )
+    {
+        runInline( ready );
+    }
+    else
+    {
+        // Held until the last action completes so the scheduler outlives whoever started it.
+        m_self = sharedFromThis();
+        foreach( int index, ready )
+        {
+            submit( index );
+        }
+    }
+
+    return future;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ActionScheduler::runInline(QList<int> ready)
+{
+    while ( !ready.isEmpty() )
+    {
+        // The ready list is kept in the order actions were queued so the first of the highest priority wins ties.
+        int next = 0;
+        for ( int i = 1; i < ready.count(); ++i )
+        {
+            if ( m_nodes[ready[i]].argument->priority() > m_nodes[ready[next]].argument->priority() ) next = i;
+        }
+
+        int index = ready.takeAt( next );
+        if ( !invoke( index ) )
+        {
+            // Like an action which is not deferred the failure stops the rest, the future still finishes so nobody waits forever.
+            m_finished.reportFinished();
+            std::rethrow_exception( m_failure );
+        }
+
+        foreach( int dependent, complete( index ) )
+        {
+            QList<int>::iterator position = std::lower_bound( ready.begin(), ready.end(), dependent );
+            ready.insert( position - ready.begin(), dependent );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ActionScheduler::invoke(int index)
+{
+    const Node& node = m_nodes.at( index );
+    try
+    {
+        node.argument->invoke( node.value );
+        return true;
+    }
+    catch ( const QException& exception )
+    {
+        fail( std::current_exception(), exception );
+    }
+    catch ( const std::exception& exception )
+    {
+        qWarning( "%s", qPrintable( QString("The action of %1 failed: %2").arg( node.argument->name(), QString::fromLocal8Bit( exception.what() ) ) ) );
+        fail( std::current_exception(), QUnhandledException() );
+    }
+    catch ( ... )
+    {
+        qWarning( "%s", qPrintable( QString("The action of %1 failed").arg( node.argument->name() ) ) );
+        fail( std::current_exception(), QUnhandledException() );
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ActionScheduler::fail(std::exception_ptr failure, const QException& reported)
+{
+    {
+        QMutexLocker locker( &m_lock );
+        if ( !m_failure ) m_failure = failure;
+    }
+    // Only the first exception is kept by the future, waiting on it rethrows that one.
+    m_finished.reportException( reported );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ActionScheduler::submit(int index)
+{
+    m_pool->start( new ActionTask( m_self, index ), m_nodes[index].argument->priority() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<int> ActionScheduler::complete(int index)
+{
+    QList<int> ready;
+    bool finished = false;
+    {
+        QMutexLocker locker( &m_lock );
+        foreach( int dependent, m_nodes[index].dependents )
+        {
+            if ( --m_nodes[dependent].waitingOn == 0 ) ready.append( dependent );
+        }
+        finished = ( --m_remaining == 0 );
+    }
+
+    if ( finished )
+    {
+        m_finished.reportFinished();
+        m_self.clear();
+    }
+    return ready;
+}
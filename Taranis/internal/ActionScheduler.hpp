@@ -0,0 +1,99 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ACTIONSCHEDULER_HPP
+#define ACTIONSCHEDULER_HPP
+
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QVariant>
+#include <QMutex>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QSharedPointer>
+#include <exception>
+
+class QThreadPool;
+class QException;
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+
+        /**
+         * @brief The ActionScheduler class executes a batch of deferred action handlers while respecting the dependencies between their arguments.
+         * An action only starts once the actions of every argument it depends on have finished, actions of arguments which
+         * are not in the batch are considered finished. Of the actions ready to go the one with the highest priority goes first.
+         *
+         * With a thread pool the actions are executed on the pool and independent actions run concurrently. Without one the
+         * actions are executed on the calling thread before start() returns.
+         *
+         * An action which throws does not stop the others on a thread pool, its dependents still run and the exception is
+         * reported through the future, a QException is passed on as is and anything else as a QUnhandledException. Without
+         * a thread pool the first exception stops the remaining actions and is rethrown from start().
+         *
+         * The scheduler keeps itself alive until every action has finished.
+         */
+        class ActionScheduler : public QEnableSharedFromThis<ActionScheduler>
+        {
+        public:
+            ActionScheduler(const QList< QPair<Argument*, QVariant> >& actions, QThreadPool* pool);
+
+            /**
+             * @brief start begins executing the actions.
+             * @return Returns a future which finishes once all the actions have finished.
+             */
+            QFuture<void> start();
+
+        private:
+            struct Node
+            {
+                Argument* argument;
+                QVariant value;
+                int waitingOn;
+                QList<int> dependents;
+            };
+
+            QVector<Node> m_nodes;
+            QThreadPool* m_pool;
+            QMutex m_lock;
+            int m_remaining;
+            QFutureInterface<void> m_finished;
+            QSharedPointer<ActionScheduler> m_self;
+            std::exception_ptr m_failure;
+
+            void runInline( QList<int> ready );
+            bool invoke( int index );
+            void fail( std::exception_ptr failure, const QException& reported );
+            void submit( int index );
+            QList<int> complete( int index );
+
+            friend class ActionTask;
+        };
+    }
+}
+
+#endif // ACTIONSCHEDULER_HPP
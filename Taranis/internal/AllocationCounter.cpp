@@ -0,0 +1,178 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "AllocationCounter.hpp"
+
+#ifdef TARANIS_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<quint64> g_allocations( 0 );
+    std::atomic<quint64> g_bytes( 0 );
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void count( std::size_t size )
+    {
+        g_allocations.fetch_add( 1, std::memory_order_relaxed );
+        g_bytes.fetch_add( size, std::memory_order_relaxed );
+    }
+}
+
+#ifdef __GLIBC__
+
+// Qt takes the storage of its strings and containers straight from malloc, counting operator new alone would miss
+// nearly all of it. Glibc lets a program replace malloc and friends and exposes its own under __libc_ names, the
+// default operator new is built on malloc so it is counted here as well.
+extern "C"
+{
+    void* __libc_malloc( std::size_t size );
+    void* __libc_calloc( std::size_t count, std::size_t size );
+    void* __libc_realloc( void* memory, std::size_t size );
+    void __libc_free( void* memory );
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void* malloc( std::size_t size )
+    {
+        count( size );
+        return __libc_malloc( size );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void* calloc( std::size_t number, std::size_t size )
+    {
+        count( number * size );
+        return __libc_calloc( number, size );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void* realloc( void* memory, std::size_t size )
+    {
+        // Growing a container in place is still the churn being looked for, so every call counts.
+        count( size );
+        return __libc_realloc( memory, size );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void free( void* memory )
+    {
+        __libc_free( memory );
+    }
+}
+
+#else
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void* countedAllocate( std::size_t size )
+    {
+        count( size );
+        return std::malloc( size == 0 ? 1 : size );
+    }
+}
+
+// Without glibc there is no portable way to replace malloc, only operator new is counted.
+////////////////////////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size )
+{
+    void* memory = countedAllocate( size );
+    if ( memory == nullptr ) throw std::bad_alloc();
+    return memory;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size )
+{
+    void* memory = countedAllocate( size );
+    if ( memory == nullptr ) throw std::bad_alloc();
+    return memory;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    return countedAllocate( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    return countedAllocate( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void operator delete( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Taranis::Internal::AllocationCounter::isEnabled()
+{
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 Taranis::Internal::AllocationCounter::allocations()
+{
+    return g_allocations.load( std::memory_order_relaxed );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 Taranis::Internal::AllocationCounter::bytes()
+{
+    return g_bytes.load( std::memory_order_relaxed );
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Taranis::Internal::AllocationCounter::isEnabled()
+{
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 Taranis::Internal::AllocationCounter::allocations()
+{
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 Taranis::Internal::AllocationCounter::bytes()
+{
+    return 0;
+}
+
+#endif
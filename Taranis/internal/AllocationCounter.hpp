@@ -0,0 +1,48 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <QtGlobal>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The AllocationCounter namespace reports how many heap allocations the process has made.
+         * Counting replaces malloc, calloc, realloc and free on glibc, which covers operator new and the storage of the
+         * Qt strings and containers. Elsewhere only the global operator new is replaced. Either way it is only compiled
+         * in when Taranis is built with <i>CONFIG += taranis_count_allocations</i>, otherwise every count is zero.
+         */
+        namespace AllocationCounter
+        {
+            bool isEnabled();
+            quint64 allocations();
+            quint64 bytes();
+        }
+    }
+}
+
+#endif // ALLOCATIONCOUNTER_HPP
@@ -30,7 +30,12 @@ Argument::Argument(const QString name, const QString description, const Argument
     m_name( name ),
     m_description( description ),
     m_type( type ),
-    m_actionCallback( callback )
+    m_actionCallback( callback ),
+    m_priority( 0 ),
+    // Dotted names live in a namespace, such as cache.size and cache.path, taking the first letter would collide.
+    m_shortNameEnabled( !name.contains( QChar('.') ) ),
+    m_hidden( false ),
+    m_payload( false )
 {
     switch (m_type)
     {
@@ -57,7 +62,37 @@ QString Argument::shortName() const
 ////////////////////////////////////////////////////////////////////////////////////////////////
 bool Argument::hasShortName() const
 {
-    return m_name.length() > 1;
+    return m_shortNameEnabled && ( m_name.length() > 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setShortNameEnabled(bool enabled)
+{
+    m_shortNameEnabled = enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::isHidden() const
+{
+    return m_hidden;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setHidden(bool hidden)
+{
+    m_hidden = hidden;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::isPayload() const
+{
+    return m_payload;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setPayload(bool payload)
+{
+    m_payload = payload;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -85,7 +120,114 @@ void Argument::setValue(QVariant value)
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-std::function<void(QVariant)> Argument::callback()
+const std::function<void(QVariant)>& Argument::callback() const
 {
     return m_actionCallback;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::hasCallback() const
+{
+    return static_cast<bool>( m_actionCallback );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::invoke(const QVariant& value) const
+{
+    m_actionCallback( value );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int Argument::priority() const
+{
+    return m_priority;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setPriority(int priority)
+{
+    m_priority = priority;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const ArgumentBinding& Argument::binding() const
+{
+    return m_binding;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setBinding(const ArgumentBinding& binding)
+{
+    m_binding = binding;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<Argument*> Argument::dependencies() const
+{
+    return m_dependencies;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::addDependency(Argument* argument)
+{
+    if ( !m_dependencies.contains( argument ) ) m_dependencies.append( argument );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::dependsOn(const Argument* argument) const
+{
+    foreach( Argument* dependency, m_dependencies )
+    {
+        if ( ( dependency == argument ) || dependency->dependsOn( argument ) ) return true;
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList Argument::completions(const QString& partial) const
+{
+    if ( !m_completionProvider ) return m_choices.choices();
+    return m_completionProvider( partial );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::hasCompletionProvider() const
+{
+    return static_cast<bool>( m_completionProvider );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setCompletionProvider(std::function<QStringList(QString)> provider)
+{
+    m_completionProvider = provider;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const ChoiceTable& Argument::choices() const
+{
+    return m_choices;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Argument::hasChoices() const
+{
+    return !m_choices.isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::setChoices(const ChoiceTable& choices)
+{
+    m_choices = choices;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const QList<ArgumentValidator>& Argument::validators() const
+{
+    return m_validators;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void Argument::addValidator(const ArgumentValidator& validator)
+{
+    m_validators.append( validator );
+}
@@ -26,8 +26,13 @@
 
 #include <QString>
 #include <QVariant>
+#include <QList>
+#include <QStringList>
 #include <functional>
 #include "ArgumentType.hpp"
+#include "ArgumentBinding.hpp"
+#include "ChoiceTable.hpp"
+#include "ArgumentValidator.hpp"
 
 namespace Taranis
 {
@@ -47,6 +52,19 @@ namespace Taranis
             QString name() const;
             QString shortName() const;
             bool hasShortName() const;
+            void setShortNameEnabled( bool enabled );
+
+            /**
+             * @brief isHidden tells you if the argument is left out of the help message.
+             */
+            bool isHidden() const;
+            void setHidden( bool hidden );
+
+            /**
+             * @brief isPayload tells if the value is stored as a Payload, which can be read from a file or stdin.
+             */
+            bool isPayload() const;
+            void setPayload( bool payload );
             QString description() const;
             ArgumentType type() const;
             QVariant value() const;
@@ -57,7 +75,57 @@ namespace Taranis
              * The call back could be as simple as setting a value to be read by your program later or it could
              * be a handler that performs some action when an argument is present and/or at a given value.
              */
-            std::function<void(QVariant)> callback();
+            const std::function<void(QVariant)>& callback() const;
+            bool hasCallback() const;
+
+            /**
+             * @brief invoke will execute the callback, which is called in place rather then copied.
+             */
+            void invoke( const QVariant& value ) const;
+
+            /**
+             * @brief priority decides the order deferred callbacks are executed in, higher priorities go first.
+             */
+            int priority() const;
+            void setPriority( int priority );
+
+            /**
+             * @brief dependencies are the arguments whose deferred callbacks must finish before this arguments callback starts.
+             */
+            QList<Argument*> dependencies() const;
+            void addDependency( Argument* argument );
+
+            /**
+             * @brief dependsOn checks if this argument depends on the given argument, directly or through other arguments.
+             */
+            bool dependsOn( const Argument* argument ) const;
+
+            /**
+             * @brief binding is the caller owned storage the arguments value is written to, if any.
+             */
+            const ArgumentBinding& binding() const;
+            void setBinding( const ArgumentBinding& binding );
+
+            /**
+             * @brief completions asks the completion provider for the values which could complete the given partial value.
+             * Without a provider the choices of a choice argument are offered.
+             */
+            QStringList completions( const QString& partial ) const;
+            bool hasCompletionProvider() const;
+            void setCompletionProvider( std::function<QStringList(QString)> provider );
+
+            /**
+             * @brief choices are the values a choice argument accepts, the value stored is the ordinal of the choice.
+             */
+            const ChoiceTable& choices() const;
+            bool hasChoices() const;
+            void setChoices( const ChoiceTable& choices );
+
+            /**
+             * @brief validators check the value given to the argument before it is applied.
+             */
+            const QList<ArgumentValidator>& validators() const;
+            void addValidator( const ArgumentValidator& validator );
 
         private:
             QString m_name;
@@ -65,6 +133,15 @@ namespace Taranis
             ArgumentType m_type;
             QVariant m_value;
             std::function<void(QVariant)> m_actionCallback;
+            ArgumentBinding m_binding;
+            int m_priority;
+            bool m_shortNameEnabled;
+            bool m_hidden;
+            bool m_payload;
+            QList<Argument*> m_dependencies;
+            std::function<QStringList(QString)> m_completionProvider;
+            ChoiceTable m_choices;
+            QList<ArgumentValidator> m_validators;
         };
     }
 }
@@ -0,0 +1,180 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QMetaObject>
+#include <QMetaProperty>
+#include "ArgumentBinding.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding() :
+    m_kind( Unbound ),
+    m_storage( nullptr ),
+    m_propertyIndex( -1 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding(bool* storage) :
+    m_kind( BoolStorage ),
+    m_storage( storage ),
+    m_propertyIndex( -1 )
+{
+    Q_ASSERT_X( storage != nullptr, "ArgumentBinding", "Can not bind to a null pointer." );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding(int* storage) :
+    m_kind( IntStorage ),
+    m_storage( storage ),
+    m_propertyIndex( -1 )
+{
+    Q_ASSERT_X( storage != nullptr, "ArgumentBinding", "Can not bind to a null pointer." );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding(double* storage) :
+    m_kind( DoubleStorage ),
+    m_storage( storage ),
+    m_propertyIndex( -1 )
+{
+    Q_ASSERT_X( storage != nullptr, "ArgumentBinding", "Can not bind to a null pointer." );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding(QString* storage) :
+    m_kind( StringStorage ),
+    m_storage( storage ),
+    m_propertyIndex( -1 )
+{
+    Q_ASSERT_X( storage != nullptr, "ArgumentBinding", "Can not bind to a null pointer." );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentBinding::ArgumentBinding(QObject* object, const char* property) :
+    m_kind( PropertyStorage ),
+    m_storage( nullptr ),
+    m_object( object ),
+    m_propertyIndex( object ? object->metaObject()->indexOfProperty( property ) : -1 )
+{
+    Q_ASSERT_X( m_propertyIndex >= 0, "ArgumentBinding", QString("No property named %1").arg(property).toLatin1().data() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentBinding::isBound() const
+{
+    return m_kind != Unbound;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ArgumentBinding::writeFlag() const
+{
+    switch ( m_kind )
+    {
+    case BoolStorage:
+        *static_cast<bool*>( m_storage ) = true;
+        break;
+    default:
+        write( true );
+        break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ArgumentBinding::writeText(const QString& text) const
+{
+    bool ok = true;
+    switch ( m_kind )
+    {
+    case StringStorage:
+        *static_cast<QString*>( m_storage ) = text;
+        break;
+    case IntStorage:
+    {
+        int value = text.toInt( &ok );
+        if ( ok ) *static_cast<int*>( m_storage ) = value;
+        break;
+    }
+    case DoubleStorage:
+    {
+        double value = text.toDouble( &ok );
+        if ( ok ) *static_cast<double*>( m_storage ) = value;
+        break;
+    }
+    default:
+        write( text );
+        break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ArgumentBinding::write(const QVariant& value) const
+{
+    switch ( m_kind )
+    {
+    case BoolStorage:
+        *static_cast<bool*>( m_storage ) = value.toBool();
+        break;
+    case StringStorage:
+        *static_cast<QString*>( m_storage ) = value.toString();
+        break;
+    case IntStorage:
+    case DoubleStorage:
+        writeText( value.toString() );
+        break;
+    case PropertyStorage:
+        if ( !m_object.isNull() && ( m_propertyIndex >= 0 ) )
+        {
+            m_object->metaObject()->property( m_propertyIndex ).write( m_object.data(), value );
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ArgumentBinding::read() const
+{
+    switch ( m_kind )
+    {
+    case BoolStorage:
+        return *static_cast<bool*>( m_storage );
+    case IntStorage:
+        return *static_cast<int*>( m_storage );
+    case DoubleStorage:
+        return *static_cast<double*>( m_storage );
+    case StringStorage:
+        return *static_cast<QString*>( m_storage );
+    case PropertyStorage:
+        if ( !m_object.isNull() && ( m_propertyIndex >= 0 ) )
+        {
+            return m_object->metaObject()->property( m_propertyIndex ).read( m_object.data() );
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ARGUMENTBINDING_HPP
+#define ARGUMENTBINDING_HPP
+
+#include <QString>
+#include <QVariant>
+#include <QPointer>
+#include <QObject>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The ArgumentBinding class ties an argument to storage owned by the caller.
+         * When an argument is bound its value is converted and written straight into the variable, or
+         * QObject property, as the command line is processed instead of being kept in the value store.
+         * The QMetaProperty index of a bound property is looked up once, when the binding is made.
+         */
+        class ArgumentBinding
+        {
+        public:
+            ArgumentBinding();
+            explicit ArgumentBinding(bool* storage);
+            explicit ArgumentBinding(int* storage);
+            explicit ArgumentBinding(double* storage);
+            explicit ArgumentBinding(QString* storage);
+            ArgumentBinding(QObject* object, const char* property);
+
+            bool isBound() const;
+
+            /**
+             * @brief writeFlag sets the bound storage to true.
+             */
+            void writeFlag() const;
+
+            /**
+             * @brief writeText converts the text to the type of the bound storage and writes it.
+             * If the text can't be converted the storage is left unchanged, bound numbers have a validator so processing
+             * rejects such text before it gets here.
+             */
+            void writeText(const QString& text) const;
+            void write(const QVariant& value) const;
+            QVariant read() const;
+
+        private:
+            enum Kind { Unbound, BoolStorage, IntStorage, DoubleStorage, StringStorage, PropertyStorage };
+
+            Kind m_kind;
+            void* m_storage;
+            QPointer<QObject> m_object;
+            int m_propertyIndex;
+        };
+    }
+}
+
+#endif // ARGUMENTBINDING_HPP
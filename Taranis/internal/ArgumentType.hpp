@@ -34,7 +34,9 @@ namespace Taranis
         enum ArgumentType {
             Action,     //< Action arguments will perform some action like show the version or help text.
             Boolean,    //< Boolean arguments as simple flags, they are true if present or false if not.
-            String      //< String arguments have a value. Such as an argument named ip having a value of 1.2.3.4
+            String,     //< String arguments have a value. Such as an argument named ip having a value of 1.2.3.4
+            Positional,     //< Positional arguments are inputs which are not options, identified by their position such as a source file.
+            PositionalList  //< Positional list arguments collect any number of inputs which are not options, such as a list of files.
         };
     }
 }
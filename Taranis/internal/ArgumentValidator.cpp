@@ -0,0 +1,175 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QFileInfo>
+#include "ArgumentValidator.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator::ArgumentValidator(Kind kind) :
+    m_kind( kind ),
+    m_minimum( 0 ),
+    m_maximum( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::range(double minimum, double maximum)
+{
+    ArgumentValidator validator( Range );
+    validator.m_minimum = minimum;
+    validator.m_maximum = maximum;
+    return validator;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::pattern(const QRegularExpression& expression)
+{
+    ArgumentValidator validator( Pattern );
+    validator.m_expression = expression;
+    return validator;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::existingFile()
+{
+    return ArgumentValidator( ExistingFile );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::existingDirectory()
+{
+    return ArgumentValidator( ExistingDirectory );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::hostPort()
+{
+    return ArgumentValidator( HostPort );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::integer()
+{
+    return ArgumentValidator( Integer );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator ArgumentValidator::number()
+{
+    return ArgumentValidator( Number );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ArgumentValidator::Kind ArgumentValidator::kind() const
+{
+    return m_kind;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentValidator::isExpensive() const
+{
+    return ( m_kind == ExistingFile ) || ( m_kind == ExistingDirectory );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ArgumentValidator::validate(const QString& name, const QString& value) const
+{
+    switch ( m_kind )
+    {
+    case Range:
+    {
+        bool ok = false;
+        double number = value.toDouble( &ok );
+        if ( ok && ( number >= m_minimum ) && ( number <= m_maximum ) ) return QString();
+        return QString("The value {%1} of {%2} is not a number from %3 to %4.").arg( value, name, QString::number( m_minimum ), QString::number( m_maximum ) );
+    }
+    case Pattern:
+        if ( m_expression.match( value ).hasMatch() ) return QString();
+        return QString("The value {%1} of {%2} does not match the expected format.").arg( value, name );
+    case ExistingFile:
+    {
+        QFileInfo info( value );
+        if ( info.exists() && !info.isDir() ) return QString();
+        return QString("The file {%1} given to {%2} does not exist.").arg( value, name );
+    }
+    case ExistingDirectory:
+        if ( QFileInfo( value ).isDir() ) return QString();
+        return QString("The directory {%1} given to {%2} does not exist.").arg( value, name );
+    case HostPort:
+        if ( isHostPort( value ) ) return QString();
+        return QString("The value {%1} of {%2} is not a host:port address.").arg( value, name );
+    case Integer:
+    {
+        bool ok = false;
+        value.toInt( &ok );
+        if ( ok ) return QString();
+        return QString("The value {%1} of {%2} is not a whole number.").arg( value, name );
+    }
+    case Number:
+    {
+        bool ok = false;
+        value.toDouble( &ok );
+        if ( ok ) return QString();
+        return QString("The value {%1} of {%2} is not a number.").arg( value, name );
+    }
+    }
+    return QString();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ArgumentValidator::isHostPort(const QString& value)
+{
+    // IPv6 addresses are bracketed, [::1]:8080, so their colons aren't mistaken for the port seperator.
+    int seperator = value.lastIndexOf( QChar(':') );
+    if ( seperator <= 0 ) return false;
+
+    bool ok = false;
+    uint port = value.mid( seperator + 1 ).toUInt( &ok );
+    if ( !ok || ( port == 0 ) || ( port > 65535 ) ) return false;
+
+    QString host = value.left( seperator );
+    if ( host.startsWith( QChar('[') ) )
+    {
+        if ( !host.endsWith( QChar(']') ) || ( host.length() < 3 ) ) return false;
+        for ( int i = 1; i < host.length() - 1; ++i )
+        {
+            ushort c = host.at(i).toLower().unicode();
+            bool hex = ( ( c >= '0' ) && ( c <= '9' ) ) || ( ( c >= 'a' ) && ( c <= 'f' ) );
+            if ( !hex && ( c != ':' ) && ( c != '.' ) ) return false;
+        }
+        return true;
+    }
+
+    foreach( const QString& label, host.split( QChar('.') ) )
+    {
+        if ( label.isEmpty() || label.startsWith( QChar('-') ) || label.endsWith( QChar('-') ) ) return false;
+        foreach( QChar c, label )
+        {
+            if ( !c.isLetterOrNumber() && ( c != QChar('-') ) ) return false;
+        }
+    }
+    return true;
+}
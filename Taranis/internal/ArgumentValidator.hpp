@@ -0,0 +1,83 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ARGUMENTVALIDATOR_HPP
+#define ARGUMENTVALIDATOR_HPP
+
+#include <QString>
+#include <QRegularExpression>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The ArgumentValidator class checks the value given to an argument.
+         * Validators are small values made when the argument is registered, a pattern is compiled and optimized then
+         * so checking a value never compiles anything. Checks which touch the file system are expensive and are
+         * batched up and run on a thread pool, the others are cheap enough to run while the command line is processed.
+         */
+        class ArgumentValidator
+        {
+        public:
+            enum Kind { Range, Pattern, ExistingFile, ExistingDirectory, HostPort, Integer, Number };
+
+            static ArgumentValidator range(double minimum, double maximum);
+            static ArgumentValidator pattern(const QRegularExpression& expression);
+            static ArgumentValidator existingFile();
+            static ArgumentValidator existingDirectory();
+            static ArgumentValidator hostPort();
+
+            /**
+             * @brief integer and number check that the value converts to an int or a double, they guard variables bound to an argument.
+             */
+            static ArgumentValidator integer();
+            static ArgumentValidator number();
+
+            Kind kind() const;
+
+            /**
+             * @brief isExpensive tells if the check does I/O and should be run on a thread pool.
+             */
+            bool isExpensive() const;
+
+            /**
+             * @brief validate checks a value.
+             * @param name is the name of the argument, used in the failure message.
+             * @return Returns an empty string if the value is valid otherwise a message saying what is wrong with it.
+             */
+            QString validate(const QString& name, const QString& value) const;
+
+        private:
+            Kind m_kind;
+            double m_minimum;
+            double m_maximum;
+            QRegularExpression m_expression;
+
+            explicit ArgumentValidator(Kind kind);
+            static bool isHostPort(const QString& value);
+        };
+    }
+}
+
+#endif // ARGUMENTVALIDATOR_HPP
@@ -0,0 +1,158 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QSet>
+#include <algorithm>
+#include "ChoiceTable.hpp"
+
+using namespace Taranis::Internal;
+
+namespace
+{
+    const uint SEEDATTEMPTS = 1 << 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ChoiceTable::ChoiceTable() :
+    m_bucketMask( 0 ),
+    m_slotMask( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ChoiceTable::ChoiceTable(const QStringList& choices) :
+    m_choices( choices ),
+    m_bucketMask( 0 ),
+    m_slotMask( 0 )
+{
+    // The same choice twice could never be given a slot of its own, the first one keeps its ordinal.
+    QList<int> ordinals;
+    QSet<QString> seen;
+    for ( int i = 0; i < m_choices.count(); ++i )
+    {
+        QString key = m_choices.at(i).toLower();
+        Q_ASSERT_X( !seen.contains( key ), "ChoiceTable", QString("The choice %1 is listed more then once.").arg( m_choices.at(i) ).toLatin1().data() );
+        if ( seen.contains( key ) ) continue;
+
+        seen.insert( key );
+        ordinals.append( i );
+    }
+    if ( ordinals.isEmpty() ) return;
+
+    // Keeping a fifth of the slots free lets the last, most crowded, buckets find a seed quickly.
+    uint slotCount = 1;
+    while ( slotCount < uint( ordinals.count() ) * 5 / 4 + 1 ) slotCount <<= 1;
+    while ( !build( ordinals, slotCount ) ) slotCount <<= 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ChoiceTable::build(const QList<int>& ordinals, uint slotCount)
+{
+    m_slotMask = slotCount - 1;
+    m_bucketMask = qMax( slotCount / 2, 1u ) - 1;
+    m_slots.fill( -1, int( slotCount ) );
+    m_seeds.fill( 0, int( m_bucketMask + 1 ) );
+
+    QVector< QList<int> > buckets( int( m_bucketMask + 1 ) );
+    foreach( int ordinal, ordinals )
+    {
+        buckets[ int( hash( m_choices.at( ordinal ), 0 ) & m_bucketMask ) ].append( ordinal );
+    }
+
+    // The biggest buckets are placed first while the table is still mostly empty.
+    QList<int> order;
+    for ( int i = 0; i < buckets.count(); ++i )
+    {
+        if ( !buckets.at(i).isEmpty() ) order.append( i );
+    }
+    std::stable_sort( order.begin(), order.end(), [&buckets](int a, int b) {
+        return buckets.at(a).count() > buckets.at(b).count();
+    });
+
+    foreach( int bucket, order )
+    {
+        const QList<int>& members = buckets.at( bucket );
+        QList<int> taken;
+        uint seed = 1;
+        for ( ; seed <= SEEDATTEMPTS; ++seed )
+        {
+            taken.clear();
+            foreach( int ordinal, members )
+            {
+                int slot = int( hash( m_choices.at( ordinal ), seed ) & m_slotMask );
+                if ( ( m_slots.at( slot ) >= 0 ) || taken.contains( slot ) ) break;
+                taken.append( slot );
+            }
+            if ( taken.count() == members.count() ) break;
+        }
+        if ( seed > SEEDATTEMPTS ) return false;
+
+        for ( int i = 0; i < members.count(); ++i )
+        {
+            m_slots[ taken.at(i) ] = members.at(i);
+        }
+        m_seeds[ bucket ] = seed;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+uint ChoiceTable::hash(const QString& value, uint seed)
+{
+    // FNV-1a over the lower cased characters so the lookup never has to allocate a lower cased copy.
+    uint hash = 2166136261u ^ ( seed * 0x9E3779B9u );
+    const QChar* data = value.constData();
+    for ( int i = 0; i < value.length(); ++i )
+    {
+        hash ^= data[i].toLower().unicode();
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    return hash ^ ( hash >> 13 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ChoiceTable::ordinal(const QString& value) const
+{
+    if ( m_slots.isEmpty() ) return -1;
+
+    uint seed = m_seeds.at( int( hash( value, 0 ) & m_bucketMask ) );
+    int slot = m_slots.at( int( hash( value, seed ) & m_slotMask ) );
+    if ( ( slot < 0 ) || ( m_choices.at(slot).compare( value, Qt::CaseInsensitive ) != 0 ) ) return -1;
+    return slot;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ChoiceTable::choices() const
+{
+    return m_choices;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ChoiceTable::isEmpty() const
+{
+    return m_choices.isEmpty();
+}
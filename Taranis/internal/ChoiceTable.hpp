@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CHOICETABLE_HPP
+#define CHOICETABLE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The ChoiceTable class maps the allowed values of a choice argument to their ordinal, their position in the list.
+         * The table is a frozen perfect hash built when the argument is registered. A first hash picks a bucket and each bucket
+         * stores the seed for a second hash which puts every choice in the bucket into a slot of its own, so looking a value up
+         * is two hashes, one slot and one string comparison no matter how many choices there are. Choices are matched
+         * ignoring case, the same as argument names.
+         */
+        class ChoiceTable
+        {
+        public:
+            ChoiceTable();
+            explicit ChoiceTable(const QStringList& choices);
+
+            /**
+             * @brief ordinal looks up the position of a value in the list of choices.
+             * @return Returns the ordinal of the value or -1 if it is not one of the choices.
+             */
+            int ordinal(const QString& value) const;
+            QStringList choices() const;
+            bool isEmpty() const;
+
+        private:
+            QStringList m_choices;
+            QVector<uint> m_seeds;
+            QVector<int> m_slots;
+            uint m_bucketMask;
+            uint m_slotMask;
+
+            static uint hash(const QString& value, uint seed);
+            bool build(const QList<int>& ordinals, uint slotCount);
+        };
+    }
+}
+
+#endif // CHOICETABLE_HPP
@@ -0,0 +1,273 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cmath>
+#include <cstring>
+#include "ConfigurationFile.hpp"
+
+using namespace Taranis::Internal;
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    QString formatJsonNumber(double number)
+    {
+        // QString::number defaults to six significant digits, which would turn a port like 1234567 into 1.23457e+06.
+        if ( ( number == std::floor( number ) ) && ( std::fabs( number ) < 9007199254740992.0 ) )
+        {
+            return QString::number( qint64( number ) );
+        }
+
+        QString text = QString::number( number, 'g', 15 );
+        if ( text.toDouble() != number ) text = QString::number( number, 'g', 17 );
+        return text;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    bool isSpace(char c)
+    {
+        return ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    char toLowerAscii(char c)
+    {
+        return ( ( c >= 'A' ) && ( c <= 'Z' ) ) ? char( c - 'A' + 'a' ) : c;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void trim(const char*& begin, const char*& end)
+    {
+        while ( ( begin < end ) && isSpace(*begin) ) ++begin;
+        while ( ( end > begin ) && isSpace(*(end - 1)) ) --end;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void collectJsonValues(const QJsonObject& object, const QString& prefix, const QSet<QString>& keys, QHash<QString, QString>& values)
+    {
+        for ( auto it = object.constBegin(); it != object.constEnd(); ++it )
+        {
+            QString key = prefix + it.key().toLower();
+            QJsonValue value = it.value();
+
+            if ( value.isObject() )
+            {
+                collectJsonValues( value.toObject(), key + QStringLiteral("."), keys, values );
+            }
+            else if ( keys.contains( key ) )
+            {
+                if ( value.isBool() )
+                {
+                    values[key] = value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+                }
+                else if ( value.isDouble() )
+                {
+                    values[key] = formatJsonNumber( value.toDouble() );
+                }
+                else if ( value.isString() )
+                {
+                    values[key] = value.toString();
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ConfigurationFile::ConfigurationFile(const QString path) :
+    m_path( path )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString ConfigurationFile::path() const
+{
+    return m_path;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ConfigurationFile::isJson() const
+{
+    return m_path.endsWith( QStringLiteral(".json"), Qt::CaseInsensitive );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QHash<QString, QString> ConfigurationFile::read(const QSet<QString>& keys) const
+{
+    if ( keys.isEmpty() ) return QHash<QString, QString>();
+
+    QFile file( m_path );
+    if ( !file.open( QIODevice::ReadOnly ) ) return QHash<QString, QString>();
+
+    qint64 size = file.size();
+    if ( size <= 0 ) return QHash<QString, QString>();
+
+    // Mapping the file lets us skip over the entries we don't care about without copying them.
+    // Not every file system supports mapping though so fall back to reading it in when we have to.
+    QByteArray buffer;
+    const char* data = reinterpret_cast<const char*>( file.map( 0, size ) );
+    if ( data == nullptr )
+    {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    QHash<QString, QString> values = isJson() ? readJson( data, size, keys ) : readIni( data, size, keys );
+
+    if ( buffer.isNull() )
+    {
+        file.unmap( reinterpret_cast<uchar*>( const_cast<char*>( data ) ) );
+    }
+
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QHash<QString, QString> ConfigurationFile::read(const QStringList& paths, QSet<QString> keys)
+{
+    QHash<QString, QString> values;
+
+    // Later configuration files override earlier ones so read them last to first.
+    for ( int i = paths.count() - 1; ( i >= 0 ) && !keys.isEmpty(); --i )
+    {
+        QHash<QString, QString> fileValues = ConfigurationFile( paths.at(i) ).read( keys );
+        for ( auto it = fileValues.constBegin(); it != fileValues.constEnd(); ++it )
+        {
+            values[it.key()] = it.value();
+            keys.remove( it.key() );
+        }
+    }
+
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ConfigurationFile::toBool(const QString& value)
+{
+    QString normilizedValue = value.trimmed().toLower();
+    return ( normilizedValue == QStringLiteral("true") ) ||
+           ( normilizedValue == QStringLiteral("1") ) ||
+           ( normilizedValue == QStringLiteral("yes") ) ||
+           ( normilizedValue == QStringLiteral("on") );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QHash<QString, QString> ConfigurationFile::readIni(const char* data, qint64 size, const QSet<QString>& keys) const
+{
+    QSet<QByteArray> wantedKeys;
+    int longestKey(0);
+    foreach( QString key, keys )
+    {
+        QByteArray utf8Key = key.toUtf8();
+        wantedKeys.insert( utf8Key );
+        longestKey = qMax( longestKey, utf8Key.length() );
+    }
+
+    QHash<QString, QString> values;
+    QByteArray section;
+    QByteArray candidate;
+    candidate.reserve( longestKey );
+
+    const char* end = data + size;
+    const char* lineBegin = data;
+    while ( ( lineBegin < end ) && ( values.size() < wantedKeys.size() ) )
+    {
+        const char* lineEnd = static_cast<const char*>( memchr( lineBegin, '\n', end - lineBegin ) );
+        if ( lineEnd == nullptr ) lineEnd = end;
+
+        const char* begin = lineBegin;
+        const char* finish = lineEnd;
+        lineBegin = lineEnd + 1;
+        trim( begin, finish );
+
+        if ( ( begin == finish ) || ( *begin == ';' ) || ( *begin == '#' ) ) continue;
+
+        if ( *begin == '[' )
+        {
+            const char* sectionEnd = static_cast<const char*>( memchr( begin, ']', finish - begin ) );
+            if ( sectionEnd == nullptr ) continue;
+
+            const char* sectionBegin = begin + 1;
+            trim( sectionBegin, sectionEnd );
+            section = QByteArray( sectionBegin, int( sectionEnd - sectionBegin ) ).toLower();
+
+            // QSettings writes keys which don't belong to a section under [General].
+            section = ( section == "general" ) ? QByteArray() : section + '.';
+            continue;
+        }
+
+        const char* seperator = begin;
+        while ( ( seperator < finish ) && ( *seperator != '=' ) && ( *seperator != ':' ) ) ++seperator;
+        if ( seperator == finish ) continue;
+
+        const char* keyBegin = begin;
+        const char* keyEnd = seperator;
+        trim( keyBegin, keyEnd );
+
+        int keyLength = section.length() + int( keyEnd - keyBegin );
+        if ( keyLength > longestKey ) continue;
+
+        candidate.resize( keyLength );
+        char* out = candidate.data();
+        memcpy( out, section.constData(), section.length() );
+        out += section.length();
+        for ( const char* c = keyBegin; c < keyEnd; ++c ) *out++ = toLowerAscii( *c );
+
+        if ( !wantedKeys.contains( candidate ) ) continue;
+
+        // Only the first occurrence of a key is used.
+        QString key = QString::fromUtf8( candidate );
+        if ( values.contains( key ) ) continue;
+
+        const char* valueBegin = seperator + 1;
+        const char* valueEnd = finish;
+        trim( valueBegin, valueEnd );
+        if ( ( valueEnd - valueBegin >= 2 ) && ( *valueBegin == '"' ) && ( *(valueEnd - 1) == '"' ) )
+        {
+            ++valueBegin;
+            --valueEnd;
+        }
+
+        values[key] = QString::fromUtf8( valueBegin, int( valueEnd - valueBegin ) );
+    }
+
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QHash<QString, QString> ConfigurationFile::readJson(const char* data, qint64 size, const QSet<QString>& keys) const
+{
+    QHash<QString, QString> values;
+    QJsonDocument document = QJsonDocument::fromJson( QByteArray::fromRawData( data, int( size ) ) );
+    if ( document.isObject() )
+    {
+        collectJsonValues( document.object(), QString(), keys, values );
+    }
+
+    return values;
+}
@@ -0,0 +1,85 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CONFIGURATIONFILE_HPP
+#define CONFIGURATIONFILE_HPP
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The ConfigurationFile class reads argument values out of an INI or JSON configuration file.
+         * The file is memory mapped and only the keys which are asked for are materialized, all other
+         * entries are skipped over without being copied. INI files are scanned line by line and the scan
+         * stops as soon as every requested key has been found.
+         *
+         * INI sections are folded into the key using a dot so <i>host</i> under <i>[db]</i> is read as
+         * <i>db.host</i>, the same goes for nested objects in JSON files. Keys are matched case insensitively.
+         */
+        class ConfigurationFile
+        {
+        public:
+            explicit ConfigurationFile(const QString path);
+            ~ConfigurationFile() {}
+
+            QString path() const;
+            bool isJson() const;
+
+            /**
+             * @brief read will look up the given keys in the configuration file.
+             * @param keys are the normalized (lower case) names of the arguments to look for.
+             * @return Returns the raw values of the keys which were found, keyed by their normalized name.
+             */
+            QHash<QString, QString> read(const QSet<QString>& keys) const;
+
+            /**
+             * @brief read will look up the given keys in a set of layered configuration files.
+             * Files later in the list override files earlier in the list, each file is only asked for the keys
+             * which have not already been found in a file after it.
+             * @param paths are the paths to the configuration files.
+             * @param keys are the normalized (lower case) names of the arguments to look for.
+             * @return Returns the raw values of the keys which were found, keyed by their normalized name.
+             */
+            static QHash<QString, QString> read(const QStringList& paths, QSet<QString> keys);
+
+            /**
+             * @brief toBool converts a configuration value to a boolean, true, 1, yes, and on are all considered true.
+             */
+            static bool toBool(const QString& value);
+
+        private:
+            QString m_path;
+
+            QHash<QString, QString> readIni(const char* data, qint64 size, const QSet<QString>& keys) const;
+            QHash<QString, QString> readJson(const char* data, qint64 size, const QSet<QString>& keys) const;
+        };
+    }
+}
+
+#endif // CONFIGURATIONFILE_HPP
@@ -0,0 +1,184 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QFile>
+#include <QThreadPool>
+#include "ConfigurationWatcher.hpp"
+#include "ConfigurationFile.hpp"
+#include "ValidationBatch.hpp"
+#include "ValueStore.hpp"
+#include "Argument.hpp"
+#include "../Payload.hpp"
+#include "../TaranisExceptions.hpp"
+
+using namespace Taranis::Internal;
+using namespace Taranis::Exceptions;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ConfigurationWatcher::ConfigurationWatcher(const QStringList& paths, const QMap<QString, Argument*>& arguments, const QHash<QString, QString>& values,
+                                           QSharedPointer<ValueStore> store, QObject* parent) :
+    QObject(parent),
+    m_paths( paths ),
+    m_arguments( arguments ),
+    m_store( store ),
+    m_watcher( this ),
+    m_reloadTimer( this )
+{
+    foreach( QString key, m_arguments.keys() )
+    {
+        m_keys.insert( key );
+    }
+    QStringList failures;
+    m_values = effectiveValues( values, failures );
+
+    // Editors tend to write files in several steps, wait for things to settle before re-reading.
+    m_reloadTimer.setSingleShot( true );
+    m_reloadTimer.setInterval( 100 );
+    connect( &m_reloadTimer, &QTimer::timeout, this, [this]() {
+        try
+        {
+            reload();
+        }
+        catch ( const ValidationException& exception )
+        {
+            // Nobody is there to catch it on a file change, the old values stay until the files are fixed.
+            qWarning( "%s", exception.what() );
+        }
+    } );
+    connect( &m_watcher, &QFileSystemWatcher::fileChanged, this, &ConfigurationWatcher::onFileChanged );
+
+    watchFiles();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ConfigurationWatcher::reload()
+{
+    // Files which are replaced rather then written to drop out of the watcher so add them back.
+    watchFiles();
+
+    QStringList failures;
+    QHash<QString, QVariant> values = effectiveValues( ConfigurationFile::read( m_paths, m_keys ), failures );
+
+    QStringList changedKeys;
+    for ( auto it = m_arguments.constBegin(); it != m_arguments.constEnd(); ++it )
+    {
+        if ( values.value( it.key() ) != m_values.value( it.key() ) )
+        {
+            changedKeys.append( it.key() );
+        }
+    }
+
+    if ( changedKeys.isEmpty() && failures.isEmpty() ) return changedKeys;
+
+    // Same as the command line the changes are checked as a whole, one invalid value keeps all of the old ones.
+    QSharedPointer<ValidationBatch> validation( new ValidationBatch() );
+    foreach( QString key, changedKeys )
+    {
+        validation->add( m_arguments[key], values[key].toString() );
+    }
+    if ( !validation->isEmpty() )
+    {
+        failures.append( validation->run( QThreadPool::globalInstance() ) );
+    }
+    if ( !failures.isEmpty() ) throw ValidationException( failures );
+
+    m_values = values;
+
+    ValueBatch batch( *m_store );
+    foreach( QString key, changedKeys )
+    {
+        Argument* arg = m_arguments[key];
+        if ( !arg->hasCallback() ) m_store->setValue( arg, m_values[key] );
+    }
+    batch.commit();
+
+    foreach( QString key, changedKeys )
+    {
+        Argument* arg = m_arguments[key];
+        if ( arg->hasCallback() ) arg->invoke( m_values[key] );
+    }
+
+    return changedKeys;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QHash<QString, QVariant> ConfigurationWatcher::effectiveValues(const QHash<QString, QString>& rawValues, QStringList& failures) const
+{
+    QHash<QString, QVariant> values;
+    for ( auto it = m_arguments.constBegin(); it != m_arguments.constEnd(); ++it )
+    {
+        Argument* arg = it.value();
+        if ( !rawValues.contains( it.key() ) )
+        {
+            values[it.key()] = arg->value();
+        }
+        else if ( arg->type() == ArgumentType::Boolean )
+        {
+            values[it.key()] = ConfigurationFile::toBool( rawValues[it.key()] );
+        }
+        else if ( arg->hasChoices() )
+        {
+            int ordinal = arg->choices().ordinal( rawValues[it.key()] );
+            if ( ordinal < 0 )
+            {
+                failures.append( QString("The value {%1} is not a choice of the argument {%2}, expected one of {%3}.")
+                                 .arg( rawValues[it.key()], arg->name(), arg->choices().choices().join(", ") ) );
+                values[it.key()] = m_values.value( it.key() );
+            }
+            else
+            {
+                values[it.key()] = ordinal;
+            }
+        }
+        else if ( arg->isPayload() )
+        {
+            values[it.key()] = QVariant::fromValue( Payload( rawValues[it.key()] ) );
+        }
+        else
+        {
+            values[it.key()] = rawValues[it.key()];
+        }
+    }
+
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConfigurationWatcher::watchFiles()
+{
+    QStringList watchedFiles = m_watcher.files();
+    foreach( QString path, m_paths )
+    {
+        if ( !watchedFiles.contains( path ) && QFile::exists( path ) )
+        {
+            m_watcher.addPath( path );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConfigurationWatcher::onFileChanged(const QString& path)
+{
+    Q_UNUSED( path );
+    m_reloadTimer.start();
+}
@@ -0,0 +1,85 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CONFIGURATIONWATCHER_HPP
+#define CONFIGURATIONWATCHER_HPP
+
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QHash>
+#include <QVariant>
+#include <QStringList>
+#include <QSharedPointer>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+        class ValueStore;
+
+        /**
+         * @brief The ConfigurationWatcher class watches the configuration files of a command line interface and re-applies their values when they change.
+         * Only the arguments whose values came from the configuration files are watched, arguments provided on the command line or through
+         * the environment keep their values. Bursts of file change notifications are coalesced into a single reload.
+         *
+         * On reload only the configuration files are re-read and only the arguments whose effective value changed are touched.
+         * Stored values are published together as a single snapshot, then the callbacks of any changed arguments with
+         * custom actions are executed.
+         */
+        class ConfigurationWatcher : public QObject
+        {
+            Q_OBJECT
+        public:
+            explicit ConfigurationWatcher(const QStringList& paths, const QMap<QString, Argument*>& arguments, const QHash<QString, QString>& values,
+                                          QSharedPointer<ValueStore> store, QObject* parent = 0);
+            virtual ~ConfigurationWatcher() {}
+
+            /**
+             * @brief reload re-reads the configuration files and applies any values which changed.
+             * The changed values are checked against their choices and validators first, if any of them fails nothing is applied and
+             * a ValidationException is thrown. Reloads started by a file change report the failure as a warning instead.
+             * @return Returns the names of the arguments whose effective value changed.
+             */
+            QStringList reload();
+
+        private:
+            QStringList m_paths;
+            QMap<QString, Argument*> m_arguments;
+            QSet<QString> m_keys;
+            QHash<QString, QVariant> m_values;
+            QSharedPointer<ValueStore> m_store;
+            QFileSystemWatcher m_watcher;
+            QTimer m_reloadTimer;
+
+            QHash<QString, QVariant> effectiveValues(const QHash<QString, QString>& rawValues, QStringList& failures) const;
+            void watchFiles();
+            void onFileChanged(const QString& path);
+        };
+    }
+}
+
+#endif // CONFIGURATIONWATCHER_HPP
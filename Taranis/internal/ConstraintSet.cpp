@@ -0,0 +1,162 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ConstraintSet.hpp"
+#include "Argument.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ConstraintSet::ConstraintSet()
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ConstraintSet::bit(const Argument* arg)
+{
+    auto it = m_bits.constFind( arg );
+    if ( it != m_bits.constEnd() ) return it.value();
+
+    int index = m_names.count();
+    m_bits.insert( arg, index );
+    m_names.append( arg->name() );
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QBitArray ConstraintSet::mask(const QList<const Argument*>& group)
+{
+    QList<int> bits;
+    foreach( const Argument* arg, group )
+    {
+        bits.append( bit( arg ) );
+    }
+
+    // Sized after every member has its bit, the mask may be shorter than later presence arrays
+    // which is fine since the missing bits are taken to be off.
+    QBitArray mask( m_names.count() );
+    foreach( int index, bits )
+    {
+        mask.setBit( index );
+    }
+    return mask;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConstraintSet::addRequired(const Argument* arg)
+{
+    Constraint constraint = { Required, bit( arg ), -1, QBitArray() };
+    m_constraints.append( constraint );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConstraintSet::addRequires(const Argument* arg, const Argument* requirement)
+{
+    Constraint constraint = { Requires, bit( arg ), bit( requirement ), QBitArray() };
+    m_constraints.append( constraint );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConstraintSet::addExclusive(const QList<const Argument*>& group)
+{
+    Constraint constraint = { Exclusive, -1, -1, mask( group ) };
+    m_constraints.append( constraint );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ConstraintSet::addAtLeastOne(const QList<const Argument*>& group)
+{
+    Constraint constraint = { AtLeastOne, -1, -1, mask( group ) };
+    m_constraints.append( constraint );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ConstraintSet::isEmpty() const
+{
+    return m_constraints.isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QBitArray ConstraintSet::presence(const QSet<Argument*>& providedArguments) const
+{
+    QBitArray present( m_names.count() );
+    foreach( Argument* arg, providedArguments )
+    {
+        int index = m_bits.value( arg, -1 );
+        if ( index >= 0 ) present.setBit( index );
+    }
+    return present;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ConstraintSet::check(const QBitArray& present) const
+{
+    QStringList violations;
+    foreach( const Constraint& constraint, m_constraints )
+    {
+        switch ( constraint.kind )
+        {
+        case Required:
+            if ( !present.testBit( constraint.subject ) )
+            {
+                violations.append( QString("The argument {%1} is required.").arg( m_names.at( constraint.subject ) ) );
+            }
+            break;
+        case Requires:
+            if ( present.testBit( constraint.subject ) && !present.testBit( constraint.target ) )
+            {
+                violations.append( QString("The argument {%1} requires {%2}.").arg( m_names.at( constraint.subject ), m_names.at( constraint.target ) ) );
+            }
+            break;
+        case Exclusive:
+        case AtLeastOne:
+        {
+            QBitArray hits = present;
+            hits &= constraint.mask;
+            int count = hits.count( true );
+            if ( ( constraint.kind == Exclusive ) && ( count > 1 ) )
+            {
+                violations.append( QString("Only one of {%1} can be given.").arg( names( hits ).join( ", " ) ) );
+            }
+            else if ( ( constraint.kind == AtLeastOne ) && ( count == 0 ) )
+            {
+                violations.append( QString("At least one of {%1} must be given.").arg( names( constraint.mask ).join( ", " ) ) );
+            }
+            break;
+        }
+        }
+    }
+    return violations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ConstraintSet::names(const QBitArray& mask) const
+{
+    QStringList names;
+    for ( int i = 0; i < mask.size(); ++i )
+    {
+        if ( mask.testBit( i ) ) names.append( m_names.at( i ) );
+    }
+    return names;
+}
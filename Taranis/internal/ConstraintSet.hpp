@@ -0,0 +1,90 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CONSTRAINTSET_HPP
+#define CONSTRAINTSET_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+
+        /**
+         * @brief The ConstraintSet class holds the rules about which arguments must or must not be given together.
+         * Every argument named by a rule is given a bit, processing the command line sets the bits of the arguments
+         * which were present and every rule is then checked against those bits in one pass. Groups are kept as a mask
+         * so checking one is an and of two bit arrays and a count.
+         */
+        class ConstraintSet
+        {
+        public:
+            ConstraintSet();
+
+            void addRequired( const Argument* arg );
+            void addRequires( const Argument* arg, const Argument* requirement );
+            void addExclusive( const QList<const Argument*>& group );
+            void addAtLeastOne( const QList<const Argument*>& group );
+            bool isEmpty() const;
+
+            /**
+             * @brief presence makes the bit array of which constrained arguments are in the given set.
+             */
+            QBitArray presence( const QSet<Argument*>& providedArguments ) const;
+
+            /**
+             * @brief check finds every rule the present arguments break.
+             * @return Returns a message for each broken rule, in the order the rules were added.
+             */
+            QStringList check( const QBitArray& present ) const;
+
+        private:
+            enum Kind { Required, Requires, Exclusive, AtLeastOne };
+
+            struct Constraint
+            {
+                Kind kind;
+                int subject;
+                int target;
+                QBitArray mask;
+            };
+
+            QHash<const Argument*, int> m_bits;
+            QStringList m_names;
+            QList<Constraint> m_constraints;
+
+            int bit( const Argument* arg );
+            QBitArray mask( const QList<const Argument*>& group );
+            QStringList names( const QBitArray& mask ) const;
+        };
+    }
+}
+
+#endif // CONSTRAINTSET_HPP
@@ -27,37 +27,33 @@
 using namespace Taranis::Internal;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-InputArgument::InputArgument(const QString arg, QStringList acceptedArgumentPrefixs, QObject *parent) :
-    QObject(parent),
-    m_originalInput( arg ),
-    m_acceptedArgumentPrefixs(acceptedArgumentPrefixs)
+InputArgument::InputArgument(const QString& arg, const QStringList& acceptedArgumentPrefixs) :
+    m_originalInput( arg )
 {
-    // Sorting the list in reverse ensures that -- is checked before - preventing false hits.
-    std::reverse( m_acceptedArgumentPrefixs.begin(), m_acceptedArgumentPrefixs.end() );
-    clipPrefix();
+    clipPrefix( acceptedArgumentPrefixs );
     updateValue();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-void InputArgument::clipPrefix()
+void InputArgument::clipPrefix(const QStringList& acceptedArgumentPrefixs)
 {
-    if ( !updatePrefix() ) return;
-    m_argument = m_originalInput.trimmed().remove(0, m_prefix.length());
+    if ( !updatePrefix( acceptedArgumentPrefixs ) ) return;
+    m_argument = m_originalInput.trimmed().mid( m_prefix.length() );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-bool InputArgument::updatePrefix()
+bool InputArgument::updatePrefix(const QStringList& acceptedArgumentPrefixs)
 {
-    foreach( QString prefix, m_acceptedArgumentPrefixs )
+    // The longest matching prefix wins so -- is not mistaken for - followed by a dash.
+    foreach( const QString& prefix, acceptedArgumentPrefixs )
     {
-        if ( m_originalInput.startsWith( prefix, Qt::CaseInsensitive) )
+        if ( ( prefix.length() > m_prefix.length() ) && m_originalInput.startsWith( prefix, Qt::CaseInsensitive ) )
         {
             m_prefix = prefix;
-            return true;
         }
     }
 
-    return false;
+    return !m_prefix.isEmpty();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -73,6 +69,21 @@ void InputArgument::updateValue()
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+void InputArgument::attachValue(const QString& value)
+{
+    // Without a value the seperator, if there was one, is still on the end of the name, i.e. address=
+    int seperatorIndex = m_nameValueSeperator.isEmpty() ? m_argument.length() : m_argument.indexOf( m_nameValueSeperator );
+    if ( seperatorIndex <= 0 ) return;
+
+    m_argument.truncate( seperatorIndex );
+    m_value = value;
+    if ( m_nameValueSeperator.isEmpty() )
+    {
+        m_nameValueSeperator = QStringLiteral(":");
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 QString InputArgument::name() const
 {
@@ -24,7 +24,6 @@
 #ifndef INPUTARGUMENT_HPP
 #define INPUTARGUMENT_HPP
 
-#include <QObject>
 #include <QStringList>
 #include <QVariant>
 
@@ -34,13 +33,12 @@ namespace Taranis
     {
         /**
          * @brief The InputArgument class parses the users input string and identifies the prefix, argument name and value.
+         * One is created for every option on the command line so it is a plain value type which lives on the stack.
          */
-        class InputArgument : public QObject
+        class InputArgument
         {
-            Q_OBJECT
         public:
-            explicit InputArgument(const QString arg, QStringList acceptedArgumentPrefixs, QObject *parent = 0);
-            virtual ~InputArgument() {}
+            InputArgument(const QString& arg, const QStringList& acceptedArgumentPrefixs);
 
             QString name() const;
             QString prefix() const;
@@ -49,15 +47,22 @@ namespace Taranis
             QVariant value() const;
             bool hasValue() const;
 
+            /**
+             * @brief attachValue gives the argument the value which followed it as a separate input, i.e. --address 1.2.3.4
+             * It is applied to the already parsed argument so the input is never joined back together and lexed a second time.
+             * An empty input, i.e. --prefix "", is kept as an empty value, it is the only way to give one.
+             * @param value is the input which followed the argument.
+             */
+            void attachValue(const QString& value);
+
         private:
-            const QString m_originalInput;
+            QString m_originalInput;
             QString m_argument;
             QString m_prefix;
             QString m_nameValueSeperator;
             QVariant m_value;
-            QStringList m_acceptedArgumentPrefixs;
-            void clipPrefix();
-            bool updatePrefix();
+            void clipPrefix(const QStringList& acceptedArgumentPrefixs);
+            bool updatePrefix(const QStringList& acceptedArgumentPrefixs);
             void updateValue();
         };
     }
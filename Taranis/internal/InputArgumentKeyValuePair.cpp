@@ -25,16 +25,17 @@
 
 using namespace Taranis::Internal;
 
+const QStringList InputArgumentKeyValuePair::DEFAULTSEPERATORS( {"=", ":"} );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
-InputArgumentKeyValuePair::InputArgumentKeyValuePair(const QString arg, QObject* parent) :
-    InputArgumentKeyValuePair( arg, {"=", ":"}, parent )
+InputArgumentKeyValuePair::InputArgumentKeyValuePair(const QString& arg) :
+    InputArgumentKeyValuePair( arg, DEFAULTSEPERATORS )
 {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-InputArgumentKeyValuePair::InputArgumentKeyValuePair(const QString arg, QStringList valueSeperators, QObject* parent) :
-    QObject(parent),
+InputArgumentKeyValuePair::InputArgumentKeyValuePair(const QString& arg, const QStringList& valueSeperators) :
     m_valueSeperators( valueSeperators ),
     m_originalArgumentString(arg)
 {
@@ -44,19 +45,20 @@ InputArgumentKeyValuePair::InputArgumentKeyValuePair(const QString arg, QStringL
 ////////////////////////////////////////////////////////////////////////////////////////////////
 QPair<QString, int> InputArgumentKeyValuePair::getSeperatorInfo(const QString argument) const
 {
-    int index(-1);
-    QString sep;
-
-    for( auto seperator : m_valueSeperators )
+    // A single walk over the argument which stops at the first seperator, searching for each
+    // seperator in turn would rescan the whole argument once per seperator that is not in it.
+    int length = argument.length();
+    for ( int index = 0; index < length; ++index )
     {
-        int seperator_index = argument.indexOf(seperator);
-        if ( ( seperator_index >= 0 ) && ( (seperator_index < index ) || ( index == -1 ) ) )
+        for ( const QString& seperator : m_valueSeperators )
         {
-            index = seperator_index;
-            sep = seperator;
+            if ( !seperator.isEmpty() && ( argument.at(index) == seperator.at(0) ) && argument.midRef( index, seperator.length() ) == seperator )
+            {
+                return qMakePair( seperator, index );
+            }
         }
     }
-    return qMakePair(sep, index);
+    return qMakePair( QString(), -1 );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
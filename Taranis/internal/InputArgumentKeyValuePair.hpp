@@ -24,7 +24,6 @@
 #ifndef INPUTARGUMENTKEYVALUEPAIR_HPP
 #define INPUTARGUMENTKEYVALUEPAIR_HPP
 
-#include <QObject>
 #include <QStringList>
 #include <QString>
 
@@ -46,12 +45,11 @@ namespace Taranis
          *    address=1.23.4.5
          *    address 1.23.4.5
          */
-        class InputArgumentKeyValuePair : QObject
+        class InputArgumentKeyValuePair
         {
         public:
-            explicit InputArgumentKeyValuePair(const QString arg, QObject *parent = 0);
-            explicit InputArgumentKeyValuePair(const QString arg, QStringList acceptedArgumentPrefixs, QObject *parent = 0);
-            ~InputArgumentKeyValuePair() {}
+            explicit InputArgumentKeyValuePair(const QString& arg);
+            InputArgumentKeyValuePair(const QString& arg, const QStringList& valueSeperators);
 
             QString key() const;
             QString value() const;
@@ -64,6 +62,7 @@ namespace Taranis
             QString m_seperator;
             QStringList m_valueSeperators;
             QString m_originalArgumentString;
+            static const QStringList DEFAULTSEPERATORS;
 
             /**
              * @brief getSeperatorInfo will detect a value seperator.
@@ -0,0 +1,155 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QMutexLocker>
+#include "Interpolator.hpp"
+#include "Argument.hpp"
+#include "ValueStore.hpp"
+#include "TaranisExceptions.hpp"
+
+using namespace Taranis::Internal;
+using namespace Taranis::Exceptions;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+Interpolator::Interpolator(QSharedPointer<ValueStore> values) :
+    m_values( values ),
+    m_generation( -1 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool Interpolator::hasPlaceholders(const QVariant& value)
+{
+    return ( value.type() == QVariant::String ) && value.toString().contains( QStringLiteral("${") );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant Interpolator::value(const Argument* arg, const Lookup& lookup)
+{
+    QVariant value = m_values->value( arg );
+    if ( !hasPlaceholders( value ) ) return value;
+
+    QMutexLocker lock( &m_lock );
+    int generation = m_values->generation();
+    if ( generation != m_generation )
+    {
+        m_resolved.clear();
+        m_generation = generation;
+    }
+
+    QList<const Argument*> resolving;
+    return resolve( arg, lookup, resolving );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString Interpolator::resolve(const Argument* arg, const Lookup& lookup, QList<const Argument*>& resolving)
+{
+    auto resolved = m_resolved.constFind( arg );
+    if ( resolved != m_resolved.constEnd() ) return resolved.value();
+
+    int index = resolving.indexOf( arg );
+    if ( index >= 0 )
+    {
+        QStringList cycle;
+        for ( int i = index; i < resolving.count(); ++i )
+        {
+            cycle.append( resolving.at(i)->name() );
+        }
+        cycle.append( arg->name() );
+        throw InterpolationCycleException( cycle );
+    }
+
+    QVariant value = m_values->value( arg );
+    if ( !hasPlaceholders( value ) ) return value.toString();
+
+    resolving.append( arg );
+    QString result;
+    foreach( const Segment& segment, compile( value.toString(), lookup ) )
+    {
+        if ( segment.arg != nullptr )
+        {
+            result += resolve( segment.arg, lookup, resolving );
+        }
+        else if ( segment.isVariable )
+        {
+            result += QString::fromLocal8Bit( qgetenv( segment.text.toLocal8Bit().constData() ) );
+        }
+        else
+        {
+            result += segment.text;
+        }
+    }
+    resolving.removeLast();
+
+    m_resolved.insert( arg, result );
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+const QList<Interpolator::Segment>& Interpolator::compile(const QString& value, const Lookup& lookup)
+{
+    auto compiled = m_templates.constFind( value );
+    if ( compiled != m_templates.constEnd() ) return compiled.value();
+
+    QList<Segment> segments;
+    QString text;
+    int length = value.length();
+    int i = 0;
+    while ( i < length )
+    {
+        int start = value.indexOf( QStringLiteral("${"), i );
+        int end = ( start < 0 ) ? -1 : value.indexOf( QChar('}'), start + 2 );
+        if ( end < 0 )
+        {
+            text += value.mid( i );
+            break;
+        }
+
+        // A doubled dollar sign keeps the placeholder as it is, less the first dollar sign.
+        if ( ( start > i ) && ( value.at( start - 1 ).unicode() == '$' ) )
+        {
+            text += value.mid( i, start - i - 1 ) + QStringLiteral("${");
+            i = start + 2;
+            continue;
+        }
+
+        text += value.mid( i, start - i );
+        if ( !text.isEmpty() )
+        {
+            segments.append( Segment { text, nullptr, false } );
+            text.clear();
+        }
+
+        QString name = value.mid( start + 2, end - start - 2 ).trimmed();
+        segments.append( Segment { name, lookup( name ), true } );
+        i = end + 1;
+    }
+
+    if ( !text.isEmpty() )
+    {
+        segments.append( Segment { text, nullptr, false } );
+    }
+
+    return m_templates.insert( value, segments ).value();
+}
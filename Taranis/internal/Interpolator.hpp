@@ -0,0 +1,86 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef INTERPOLATOR_HPP
+#define INTERPOLATOR_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <functional>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+        class ValueStore;
+
+        /**
+         * @brief The Interpolator class expands the ${name} placeholders in the values of string arguments.
+         * A placeholder names another argument, or an environment variable if there is no such argument, and $${ is a literal ${.
+         * Nothing is done until a value is read. Each value is split into its text and placeholders once and the placeholders
+         * are looked up at that time, resolving it then only walks the pieces. Values a placeholder references are resolved
+         * first, and every resolved value is kept until a value in the store changes.
+         */
+        class Interpolator
+        {
+        public:
+            typedef std::function<Argument*(const QString&)> Lookup;
+
+            explicit Interpolator( QSharedPointer<ValueStore> values );
+
+            /**
+             * @brief value reads the value of an argument with its placeholders expanded.
+             * Values without placeholders are returned as they are without taking the lock.
+             * @param lookup finds the argument a placeholder names, or returns nullptr if there is none.
+             * @throws InterpolationCycleException if the value references itself, directly or through other values.
+             */
+            QVariant value( const Argument* arg, const Lookup& lookup );
+
+        private:
+            struct Segment
+            {
+                QString text;
+                const Argument* arg;
+                bool isVariable;
+            };
+
+            QSharedPointer<ValueStore> m_values;
+            QMutex m_lock;
+            int m_generation;
+            QHash<QString, QList<Segment> > m_templates;
+            QHash<const Argument*, QString> m_resolved;
+
+            static bool hasPlaceholders( const QVariant& value );
+            const QList<Segment>& compile( const QString& value, const Lookup& lookup );
+            QString resolve( const Argument* arg, const Lookup& lookup, QList<const Argument*>& resolving );
+        };
+    }
+}
+
+#endif // INTERPOLATOR_HPP
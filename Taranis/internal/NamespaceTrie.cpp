@@ -0,0 +1,149 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QStringList>
+#include "NamespaceTrie.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+NamespaceTrie::NamespaceTrie() :
+    m_nodes( 1 ),
+    m_count( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void NamespaceTrie::insert(const QString& path, Loader loader)
+{
+    int node = 0;
+    foreach( const QString& segment, path.split( QChar('.') ) )
+    {
+        int child = m_nodes.at(node).children.value( segment, -1 );
+        if ( child < 0 )
+        {
+            child = m_nodes.count();
+            m_nodes[node].children.insert( segment, child );
+            m_nodes.append( Node() );
+        }
+        node = child;
+    }
+
+    if ( !m_nodes.at(node).loader )
+    {
+        ++m_count;
+    }
+    m_nodes[node].loader = loader;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<int> NamespaceTrie::find(const QString& name) const
+{
+    QList<int> found;
+    if ( m_count == 0 ) return found;
+
+    // Only the segments before the last one can be a namespace, the last one is the arguments own name.
+    int node = 0;
+    int start = 0;
+    int end = name.indexOf( QChar('.') );
+    while ( end > start )
+    {
+        node = m_nodes.at(node).children.value( name.mid( start, end - start ), -1 );
+        if ( node < 0 ) break;
+
+        if ( m_nodes.at(node).loader ) found.append( node );
+
+        start = end + 1;
+        end = name.indexOf( QChar('.'), start );
+    }
+
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<int> NamespaceTrie::findUnder(const QString& path) const
+{
+    // Everything under db starts with db. and nothing else does, so this is the same as completing db.
+    return findByPrefix( path + QChar('.') );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<int> NamespaceTrie::findByPrefix(const QString& prefix) const
+{
+    QList<int> found;
+    if ( m_count == 0 ) return found;
+
+    // Every segment but the last has been typed in full, the last one is only the start of a segment.
+    QStringList segments = prefix.split( QChar('.') );
+    QString partial = segments.takeLast();
+
+    int node = 0;
+    foreach( const QString& segment, segments )
+    {
+        node = m_nodes.at(node).children.value( segment, -1 );
+        if ( node < 0 ) return found;
+
+        if ( m_nodes.at(node).loader ) found.append( node );
+    }
+
+    QList<int> pending;
+    for ( auto it = m_nodes.at(node).children.constBegin(); it != m_nodes.at(node).children.constEnd(); ++it )
+    {
+        if ( it.key().startsWith( partial ) ) pending.append( it.value() );
+    }
+
+    // Walk the nodes under the prefix breadth first so outer namespaces are still loaded first.
+    for ( int i = 0; i < pending.count(); ++i )
+    {
+        const Node& child = m_nodes.at( pending.at(i) );
+        if ( child.loader ) found.append( pending.at(i) );
+        pending.append( child.children.values() );
+    }
+
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<int> NamespaceTrie::namespaces() const
+{
+    // Children are always appended after their parent so index order puts outer namespaces first.
+    QList<int> found;
+    for ( int i = 0; i < m_nodes.count(); ++i )
+    {
+        if ( m_nodes.at(i).loader ) found.append( i );
+    }
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+NamespaceTrie::Loader NamespaceTrie::loader(int id) const
+{
+    return m_nodes.at(id).loader;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int NamespaceTrie::count() const
+{
+    return m_count;
+}
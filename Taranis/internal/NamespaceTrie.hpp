@@ -0,0 +1,103 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef NAMESPACETRIE_HPP
+#define NAMESPACETRIE_HPP
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <functional>
+
+namespace Taranis
+{
+    class CommandLineInterfaceBuilder;
+
+    namespace Internal
+    {
+        /**
+         * @brief The NamespaceTrie class indexes the loaders of namespaced arguments by their dotted path.
+         * Each segment of a path, such as <i>auth</i> and <i>ldap</i> in <i>auth.ldap</i>, is a node in the trie so
+         * finding the namespaces an argument name falls under is a walk down the trie one segment at a time.
+         *
+         * Namespaces are identified by the index of their node. The trie is only changed while the interface is being
+         * built, which namespaces have been loaded is tracked by each CommandLineInterface so copies can share one trie.
+         */
+        class NamespaceTrie
+        {
+        public:
+            typedef std::function<void(CommandLineInterfaceBuilder&)> Loader;
+
+            NamespaceTrie();
+
+            /**
+             * @brief insert adds a namespace, adding it again replaces its loader.
+             * @param path is the normalized dotted path of the namespace, such as auth.ldap
+             * @param loader is the function which registers the arguments of the namespace.
+             */
+            void insert(const QString& path, Loader loader);
+
+            /**
+             * @brief find looks up every namespace the given name falls under.
+             * @param name is a normalized argument name, such as auth.ldap.url which falls under auth and auth.ldap
+             * @return Returns the namespaces outer namespace first.
+             */
+            QList<int> find(const QString& name) const;
+
+            /**
+             * @brief findUnder looks up every namespace along a path and every namespace nested under it.
+             * @param path is a normalized dotted path, such as db which finds db, db.primary and db.replica
+             * @return Returns the namespaces outer namespace first.
+             */
+            QList<int> findUnder(const QString& path) const;
+
+            /**
+             * @brief findByPrefix looks up every namespace along a partly typed name and every namespace nested under what it could become.
+             * @param prefix is a normalized partial name, such as db.pri which finds db, db.primary and db.primary.pool
+             * @return Returns the namespaces outer namespace first.
+             */
+            QList<int> findByPrefix(const QString& prefix) const;
+
+            /**
+             * @brief namespaces returns every namespace, outer namespaces before the ones nested in them.
+             */
+            QList<int> namespaces() const;
+
+            Loader loader(int id) const;
+            int count() const;
+
+        private:
+            struct Node
+            {
+                QHash<QString, int> children;
+                Loader loader;
+            };
+
+            QVector<Node> m_nodes;
+            int m_count;
+        };
+    }
+}
+
+#endif // NAMESPACETRIE_HPP
@@ -0,0 +1,70 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "PhaseTimer.hpp"
+#include "AllocationCounter.hpp"
+
+using namespace Taranis;
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+PhaseTimer::PhaseTimer(ParseStatistics* statistics, ParseStatistics::Phase phase) :
+    m_statistics( statistics ),
+    m_phase( phase ),
+    m_start( 0 ),
+    m_allocations( 0 ),
+    m_bytes( 0 )
+{
+    if ( m_statistics == nullptr ) return;
+
+    m_start = m_statistics->now();
+    m_allocations = AllocationCounter::allocations();
+    m_bytes = AllocationCounter::bytes();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+PhaseTimer::~PhaseTimer()
+{
+    stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseTimer::stop()
+{
+    if ( m_statistics == nullptr ) return;
+
+    record( m_statistics, m_phase, m_start, m_allocations, m_bytes );
+    m_statistics = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseTimer::record(ParseStatistics* statistics, ParseStatistics::Phase phase, qint64 start, quint64 allocations, quint64 bytes)
+{
+    if ( statistics == nullptr ) return;
+
+    statistics->record( phase,
+                        start,
+                        statistics->now() - start,
+                        AllocationCounter::allocations() - allocations,
+                        AllocationCounter::bytes() - bytes );
+}
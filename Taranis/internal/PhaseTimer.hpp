@@ -0,0 +1,65 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PHASETIMER_HPP
+#define PHASETIMER_HPP
+
+#include "ParseStatistics.hpp"
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The PhaseTimer class records the time and allocations spent in its scope against a phase.
+         * If there are no statistics to record into it does nothing, so it can be left in place in hot code.
+         */
+        class PhaseTimer
+        {
+        public:
+            PhaseTimer( ParseStatistics* statistics, ParseStatistics::Phase phase );
+            ~PhaseTimer();
+
+            /**
+             * @brief stop records the phase now rather then at the end of the scope.
+             */
+            void stop();
+
+            /**
+             * @brief record adds a phase which started before there were statistics to record into, such as registration.
+             */
+            static void record( ParseStatistics* statistics, ParseStatistics::Phase phase, qint64 start, quint64 allocations, quint64 bytes );
+
+        private:
+            ParseStatistics* m_statistics;
+            ParseStatistics::Phase m_phase;
+            qint64 m_start;
+            quint64 m_allocations;
+            quint64 m_bytes;
+
+            Q_DISABLE_COPY(PhaseTimer)
+        };
+    }
+}
+
+#endif // PHASETIMER_HPP
@@ -0,0 +1,78 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "PresetTable.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void PresetTable::add(const QString& normalizedName, const QString& name, const QStringList& options, const QList<InputArgument>& inputs)
+{
+    Preset preset;
+    preset.name = name;
+    preset.options = options;
+    preset.inputs = inputs;
+    m_presets.insert( normalizedName, preset );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool PresetTable::isEmpty() const
+{
+    return m_presets.isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int PresetTable::count() const
+{
+    return m_presets.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool PresetTable::contains(const QString& normalizedName) const
+{
+    return m_presets.contains( normalizedName );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QList<InputArgument> PresetTable::expansion(const QString& normalizedName) const
+{
+    auto it = m_presets.constFind( normalizedName );
+    return ( it == m_presets.constEnd() ) ? QList<InputArgument>() : it.value().inputs;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList PresetTable::options(const QString& normalizedName) const
+{
+    return m_presets.value( normalizedName ).options;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList PresetTable::names(const QString& normalizedPrefix) const
+{
+    QStringList names;
+    for ( auto it = m_presets.lowerBound( normalizedPrefix ); ( it != m_presets.constEnd() ) && it.key().startsWith( normalizedPrefix ); ++it )
+    {
+        names.append( it.value().name );
+    }
+    return names;
+}
@@ -0,0 +1,87 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PRESETTABLE_HPP
+#define PRESETTABLE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include "InputArgument.hpp"
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        /**
+         * @brief The PresetTable class holds the presets, names which stand for a list of options.
+         * The options are lexed into InputArguments when the preset is added so using a preset only splices the
+         * already parsed inputs into the command line.
+         */
+        class PresetTable
+        {
+        public:
+            /**
+             * @brief add registers a preset.
+             * @param normalizedName is the normalized name of the preset.
+             * @param name is the name of the preset as it was given.
+             * @param options are the options the preset stands for as they were given.
+             * @param inputs are the options already lexed, with any preset they name expanded.
+             */
+            void add( const QString& normalizedName, const QString& name, const QStringList& options, const QList<InputArgument>& inputs );
+            bool isEmpty() const;
+            int count() const;
+            bool contains( const QString& normalizedName ) const;
+
+            /**
+             * @brief expansion gives the parsed options of a preset.
+             * @return Returns the options or an empty list if there is no preset with the name.
+             */
+            QList<InputArgument> expansion( const QString& normalizedName ) const;
+
+            /**
+             * @brief options gives the options of a preset as they were given, for the help.
+             */
+            QStringList options( const QString& normalizedName ) const;
+
+            /**
+             * @brief names gives the names of the presets as they were given in sorted order.
+             * @param normalizedPrefix limits the names to those whose normalized name starts with it.
+             */
+            QStringList names( const QString& normalizedPrefix = QString() ) const;
+
+        private:
+            struct Preset
+            {
+                QString name;
+                QStringList options;
+                QList<InputArgument> inputs;
+            };
+
+            QMap<QString, Preset> m_presets;
+        };
+    }
+}
+
+#endif // PRESETTABLE_HPP
@@ -0,0 +1,167 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "SchemaCache.hpp"
+#include "Argument.hpp"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QHash>
+
+using namespace Taranis::Internal;
+
+const quint32 SchemaCache::MAGIC = 0x54524E53; // TRNS
+const quint32 SchemaCache::FORMATVERSION = 1;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+SchemaCache::SchemaCache(const QString path) :
+    m_path( path )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString SchemaCache::path() const
+{
+    return m_path;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool SchemaCache::isCacheable(const Argument &argument)
+{
+    return !argument.hasCallback() && !argument.binding().isBound() && argument.dependencies().isEmpty() && !argument.hasCompletionProvider() && !argument.hasChoices() && argument.validators().isEmpty() && !argument.isPayload();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool SchemaCache::read(const QByteArray &manifestHash, QList<Argument*> &arguments, QList< QPair<QString, Argument*> > &lookup) const
+{
+    QFile file( m_path );
+    if ( !file.open( QIODevice::ReadOnly ) ) return false;
+
+    qint64 size = file.size();
+    if ( size <= 0 ) return false;
+
+    // Same as the configuration files, read straight out of the mapping and fall back to reading the file in.
+    QByteArray buffer;
+    const char* data = reinterpret_cast<const char*>( file.map( 0, size ) );
+    if ( data == nullptr )
+    {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    QDataStream in( QByteArray::fromRawData( data, int( size ) ) );
+    in.setVersion( QDataStream::Qt_5_0 );
+
+    quint32 magic( 0 );
+    quint32 version( 0 );
+    QByteArray hash;
+    quint32 argumentCount( 0 );
+    in >> magic >> version;
+    if ( ( magic == MAGIC ) && ( version == FORMATVERSION ) )
+    {
+        in >> hash >> argumentCount;
+    }
+
+    bool valid = ( magic == MAGIC ) && ( version == FORMATVERSION ) && ( hash == manifestHash ) && ( in.status() == QDataStream::Ok );
+    if ( valid )
+    {
+        for ( quint32 i = 0; ( i < argumentCount ) && ( in.status() == QDataStream::Ok ); ++i )
+        {
+            QString name;
+            QString description;
+            qint32 type( 0 );
+            QVariant value;
+            bool shortNameEnabled( true );
+            bool hidden( false );
+            qint32 priority( 0 );
+            in >> name >> description >> type >> value >> shortNameEnabled >> hidden >> priority;
+
+            auto arg = new Argument( name, description, static_cast<ArgumentType>( type ), nullptr );
+            arg->setValue( value );
+            arg->setShortNameEnabled( shortNameEnabled );
+            arg->setHidden( hidden );
+            arg->setPriority( priority );
+            arguments.append( arg );
+        }
+
+        quint32 keyCount( 0 );
+        in >> keyCount;
+        for ( quint32 i = 0; ( i < keyCount ) && ( in.status() == QDataStream::Ok ); ++i )
+        {
+            QString key;
+            quint32 index( 0 );
+            in >> key >> index;
+            if ( index >= quint32( arguments.count() ) )
+            {
+                in.setStatus( QDataStream::ReadCorruptData );
+                break;
+            }
+            lookup.append( qMakePair( key, arguments.at( int( index ) ) ) );
+        }
+
+        valid = ( in.status() == QDataStream::Ok );
+    }
+
+    if ( buffer.isNull() )
+    {
+        file.unmap( reinterpret_cast<uchar*>( const_cast<char*>( data ) ) );
+    }
+
+    if ( !valid )
+    {
+        qDeleteAll( arguments );
+        arguments.clear();
+        lookup.clear();
+    }
+    return valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool SchemaCache::write(const QByteArray &manifestHash, const QList<Argument*> &arguments, const QList< QPair<QString, Argument*> > &lookup) const
+{
+    // Written to a temporary file and moved into place so a reader never sees half a cache.
+    QSaveFile file( m_path );
+    if ( !file.open( QIODevice::WriteOnly ) ) return false;
+
+    QDataStream out( &file );
+    out.setVersion( QDataStream::Qt_5_0 );
+    out << MAGIC << FORMATVERSION << manifestHash << quint32( arguments.count() );
+
+    QHash<const Argument*, quint32> indexes;
+    foreach( Argument* arg, arguments )
+    {
+        indexes.insert( arg, quint32( indexes.count() ) );
+        out << arg->name() << arg->description() << qint32( arg->type() ) << arg->value()
+            << arg->hasShortName() << arg->isHidden() << qint32( arg->priority() );
+    }
+
+    out << quint32( lookup.count() );
+    for ( auto entry : lookup )
+    {
+        out << entry.first << indexes.value( entry.second );
+    }
+
+    return file.commit();
+}
@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef SCHEMACACHE_HPP
+#define SCHEMACACHE_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+
+        /**
+         * @brief The SchemaCache class stores a frozen set of arguments in a compact versioned binary file.
+         * The file holds every arguments name, description, type, default value and flags followed by the lookup table
+         * of normalized names and short names. Reading it back is a single pass over the memory mapped file which creates
+         * the arguments and hands back the lookup table, so none of the validation done while registering is repeated.
+         *
+         * A cache is only used if it was written by the same format version for the same manifest hash. Arguments with
+         * action handlers, bound variables or dependencies can't be stored and are never written to a cache.
+         */
+        class SchemaCache
+        {
+        public:
+            static const quint32 MAGIC;
+            static const quint32 FORMATVERSION;
+
+            explicit SchemaCache(const QString path);
+            ~SchemaCache() {}
+
+            QString path() const;
+
+            /**
+             * @brief read will load the arguments out of the cache file.
+             * @param manifestHash is the hash of whatever the arguments were generated from.
+             * @param arguments is filled with the arguments, which are owned by the caller.
+             * @param lookup is filled with the normalized names and short names of the arguments.
+             * @return Returns false if the file is missing, damaged, from another format version or for another manifest.
+             */
+            bool read(const QByteArray& manifestHash, QList<Argument*>& arguments, QList< QPair<QString, Argument*> >& lookup) const;
+
+            /**
+             * @brief write will replace the cache file with the given arguments.
+             * @return Returns false if the file could not be written.
+             */
+            bool write(const QByteArray& manifestHash, const QList<Argument*>& arguments, const QList< QPair<QString, Argument*> >& lookup) const;
+
+            /**
+             * @brief isCacheable tells if the argument can be stored, only arguments made up entirely of data can be.
+             */
+            static bool isCacheable(const Argument& argument);
+
+        private:
+            QString m_path;
+        };
+    }
+}
+
+#endif // SCHEMACACHE_HPP
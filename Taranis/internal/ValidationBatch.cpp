@@ -0,0 +1,163 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutexLocker>
+#include "ValidationBatch.hpp"
+#include "Argument.hpp"
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        namespace
+        {
+            /**
+             * @brief CHUNKSIZE is how many expensive checks a thread takes at a time.
+             * Big enough that handing out chunks costs nothing next to the stat calls, small enough to spread ~2,000 paths over the pool.
+             */
+            const int CHUNKSIZE = 32;
+        }
+
+        /**
+         * @brief The ValidationTask class works through the chunks of a ValidationBatch on a thread pool.
+         */
+        class ValidationTask : public QRunnable
+        {
+        public:
+            explicit ValidationTask(QSharedPointer<ValidationBatch> batch) :
+                m_batch( batch )
+            {
+                setAutoDelete( true );
+            }
+
+            void run() Q_DECL_OVERRIDE
+            {
+                m_batch->runChunks();
+            }
+
+        private:
+            QSharedPointer<ValidationBatch> m_batch;
+        };
+    }
+}
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValidationBatch::ValidationBatch() :
+    m_results( nullptr ),
+    m_nextChunk( 0 ),
+    m_chunkCount( 0 ),
+    m_finishedChunks( 0 )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValidationBatch::add(const Argument* argument, const QString& value)
+{
+    // Choices and payloads are not plain text, the choice table already checked the former.
+    if ( ( argument->type() != ArgumentType::String ) || argument->hasChoices() || argument->isPayload() ) return;
+
+    foreach( const ArgumentValidator& validator, argument->validators() )
+    {
+        Check check = { argument, validator, value };
+        m_checks.append( check );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool ValidationBatch::isEmpty() const
+{
+    return m_checks.isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QStringList ValidationBatch::run(QThreadPool* pool)
+{
+    // Sized up front, the tasks write to their own entries through a pointer so the vector is never touched under them.
+    m_failures.resize( m_checks.count() );
+    m_results = m_failures.data();
+    for ( int i = 0; i < m_checks.count(); ++i )
+    {
+        if ( m_checks.at(i).validator.isExpensive() )
+        {
+            m_expensive.append( i );
+        }
+        else
+        {
+            check( i );
+        }
+    }
+
+    m_chunkCount = ( m_expensive.count() + CHUNKSIZE - 1 ) / CHUNKSIZE;
+    if ( ( pool != nullptr ) && ( m_chunkCount > 1 ) )
+    {
+        int helpers = qMin( m_chunkCount, pool->maxThreadCount() ) - 1;
+        for ( int i = 0; i < helpers; ++i )
+        {
+            pool->start( new ValidationTask( sharedFromThis() ) );
+        }
+    }
+    runChunks();
+
+    {
+        QMutexLocker locker( &m_lock );
+        while ( m_finishedChunks < m_chunkCount )
+        {
+            m_finished.wait( &m_lock );
+        }
+    }
+
+    QStringList failures;
+    foreach( const QString& failure, m_failures )
+    {
+        if ( !failure.isEmpty() ) failures.append( failure );
+    }
+    return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValidationBatch::runChunks()
+{
+    for ( int chunk = m_nextChunk.fetchAndAddOrdered( 1 ); chunk < m_chunkCount; chunk = m_nextChunk.fetchAndAddOrdered( 1 ) )
+    {
+        int end = qMin( ( chunk + 1 ) * CHUNKSIZE, m_expensive.count() );
+        for ( int i = chunk * CHUNKSIZE; i < end; ++i )
+        {
+            check( m_expensive.at(i) );
+        }
+
+        QMutexLocker locker( &m_lock );
+        if ( ++m_finishedChunks == m_chunkCount ) m_finished.wakeAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValidationBatch::check(int index)
+{
+    const Check& check = m_checks.at( index );
+    m_results[index] = check.validator.validate( check.argument->name(), check.value );
+}
@@ -0,0 +1,100 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef VALIDATIONBATCH_HPP
+#define VALIDATIONBATCH_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include "ArgumentValidator.hpp"
+
+class QThreadPool;
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+
+        /**
+         * @brief The ValidationBatch class checks the values given to arguments against their validators.
+         * Cheap checks are done on the calling thread. Expensive checks, the ones which stat files, are split into chunks
+         * and handed to a thread pool. The calling thread works through the chunks as well so the batch finishes even if
+         * every thread of the pool is busy, it only waits for the chunks other threads have already started.
+         *
+         * The batch keeps itself alive until every task it started has run.
+         */
+        class ValidationBatch : public QEnableSharedFromThis<ValidationBatch>
+        {
+            friend class ValidationTask;
+        public:
+            ValidationBatch();
+
+            /**
+             * @brief add queues a value to be checked by every validator of the argument.
+             * Only the values of plain string arguments are checked, anything else is ignored.
+             */
+            void add(const Argument* argument, const QString& value);
+            bool isEmpty() const;
+
+            /**
+             * @brief run does the checks.
+             * @param pool is where to run the expensive checks, if there are only a few they are run on the calling thread.
+             * @return Returns a message for each failed check in the order the values were added.
+             */
+            QStringList run(QThreadPool* pool);
+
+        private:
+            struct Check
+            {
+                const Argument* argument;
+                ArgumentValidator validator;
+                QString value;
+            };
+
+            QVector<Check> m_checks;
+            QVector<int> m_expensive;
+            QVector<QString> m_failures;
+            QString* m_results;
+            QAtomicInt m_nextChunk;
+            int m_chunkCount;
+            int m_finishedChunks;
+            QMutex m_lock;
+            QWaitCondition m_finished;
+
+            void check(int index);
+
+            /**
+             * @brief runChunks takes chunks of expensive checks until there are none left.
+             */
+            void runChunks();
+        };
+    }
+}
+
+#endif // VALIDATIONBATCH_HPP
@@ -0,0 +1,194 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ValueStore.hpp"
+#include "Argument.hpp"
+
+using namespace Taranis::Internal;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValueStore::ValueStore() :
+    m_snapshot( new Snapshot() ),
+    m_readers( 0 ),
+    m_generation( 0 ),
+    m_writeLock( QMutex::Recursive ),
+    m_batchDepth( 0 ),
+    m_rollingBack( false )
+{
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValueStore::~ValueStore()
+{
+    delete m_snapshot.load();
+    qDeleteAll( m_retired );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QVariant ValueStore::value(const Argument* arg) const
+{
+    if ( arg->binding().isBound() )
+    {
+        // Caller owned storage is not a snapshot, a reload may be writing it from another thread. The lock is recursive
+        // because writing a property emits its notify signal, and whatever is connected may read the value back.
+        QMutexLocker locker( &m_writeLock );
+        return arg->binding().read();
+    }
+
+    m_readers.fetchAndAddOrdered( 1 );
+
+    const Snapshot* snapshot = m_snapshot.loadAcquire();
+    Snapshot::const_iterator it = snapshot->constFind( arg );
+    QVariant value = ( it != snapshot->constEnd() ) ? it.value() : arg->value();
+
+    m_readers.fetchAndAddOrdered( -1 );
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::setValue(const Argument* arg, const QVariant& value)
+{
+    QMutexLocker locker( &m_writeLock );
+    if ( arg->binding().isBound() )
+    {
+        arg->binding().write( value );
+        m_generation.fetchAndAddOrdered( 1 );
+    }
+    else if ( m_batchDepth > 0 )
+    {
+        m_staged[arg] = value;
+    }
+    else
+    {
+        Snapshot change;
+        change[arg] = value;
+        publish( change );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::apply(Argument* arg, const QVariant& value)
+{
+    if ( arg->hasCallback() )
+    {
+        arg->invoke( value );
+    }
+    else
+    {
+        setValue( arg, value );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::beginBatch()
+{
+    QMutexLocker locker( &m_writeLock );
+    ++m_batchDepth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::commitBatch()
+{
+    QMutexLocker locker( &m_writeLock );
+    Q_ASSERT_X( m_batchDepth > 0, "ValueStore::commitBatch", "commitBatch called without a matching beginBatch." );
+
+    if ( --m_batchDepth > 0 ) return;
+
+    // An inner batch which was rolled back takes the rest of the batch with it.
+    if ( !m_rollingBack && !m_staged.isEmpty() )
+    {
+        publish( m_staged );
+    }
+    m_staged.clear();
+    m_rollingBack = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::rollbackBatch()
+{
+    QMutexLocker locker( &m_writeLock );
+    Q_ASSERT_X( m_batchDepth > 0, "ValueStore::rollbackBatch", "rollbackBatch called without a matching beginBatch." );
+
+    m_rollingBack = true;
+    if ( --m_batchDepth > 0 ) return;
+
+    m_staged.clear();
+    m_rollingBack = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::publish(const Snapshot& changes)
+{
+    // The caller holds the write lock so the current snapshot can't change underneath us.
+    const Snapshot* current = m_snapshot.loadAcquire();
+    Snapshot* snapshot = new Snapshot( *current );
+    for ( Snapshot::const_iterator it = changes.constBegin(); it != changes.constEnd(); ++it )
+    {
+        snapshot->insert( it.key(), it.value() );
+    }
+
+    m_retired.append( m_snapshot.fetchAndStoreOrdered( snapshot ) );
+    m_generation.fetchAndAddOrdered( 1 );
+    reclaim();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+int ValueStore::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueStore::reclaim()
+{
+    // Readers register before loading the snapshot pointer, so if none are registered after the swap
+    // any reader which comes along later is guaranteed to load the new snapshot.
+    if ( m_readers.fetchAndAddOrdered( 0 ) != 0 ) return;
+
+    qDeleteAll( m_retired );
+    m_retired.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValueBatch::ValueBatch(ValueStore& store) :
+    m_store( store ),
+    m_open( true )
+{
+    m_store.beginBatch();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+ValueBatch::~ValueBatch()
+{
+    if ( m_open ) m_store.rollbackBatch();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void ValueBatch::commit()
+{
+    if ( !m_open ) return;
+    m_open = false;
+    m_store.commitBatch();
+}
@@ -0,0 +1,124 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef VALUESTORE_HPP
+#define VALUESTORE_HPP
+
+#include <QHash>
+#include <QList>
+#include <QVariant>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+namespace Taranis
+{
+    namespace Internal
+    {
+        class Argument;
+
+        /**
+         * @brief The ValueStore class holds the values of a command line interface's arguments.
+         * Values are kept in an immutable snapshot which is swapped out as a whole, through an atomic pointer, whenever
+         * a value changes. Reading a value never blocks: readers announce themselves on a counter, load the current
+         * snapshot, and look the value up. Writers are serialized, copy the current snapshot, apply their changes, and
+         * swap the copy in. Changes made between beginBatch() and commitBatch() are staged and published together as a
+         * single new snapshot.
+         *
+         * Replaced snapshots are only deleted once a writer sees that no readers are active, until then they are
+         * kept on a retired list. Under constant read traffic the retired snapshots are freed on the first quiet moment.
+         *
+         * Arguments which have no value in the snapshot report their default value.
+         *
+         * Arguments bound to caller owned storage bypass the snapshot, their values are written to and read from the storage directly.
+         * Those reads take the writers lock, so unlike the snapshot they can block while a batch is being written.
+         */
+        class ValueStore
+        {
+        public:
+            ValueStore();
+            ~ValueStore();
+
+            QVariant value(const Argument* arg) const;
+            void setValue(const Argument* arg, const QVariant& value);
+
+            /**
+             * @brief apply will hand the value to the arguments callback, or store it if the argument does not have a callback.
+             */
+            void apply(Argument* arg, const QVariant& value);
+
+            void beginBatch();
+            void commitBatch();
+
+            /**
+             * @brief rollbackBatch ends a batch without publishing it, the values staged since beginBatch() are dropped.
+             * Nested batches are rolled back as a whole once the outermost one ends.
+             */
+            void rollbackBatch();
+
+            /**
+             * @brief generation is bumped whenever a value changes, anything derived from the values can tell it is stale by comparing it.
+             */
+            int generation() const;
+
+        private:
+            typedef QHash<const Argument*, QVariant> Snapshot;
+
+            QAtomicPointer<const Snapshot> m_snapshot;
+            mutable QAtomicInt m_readers;
+            QAtomicInt m_generation;
+            mutable QMutex m_writeLock;
+            QList<const Snapshot*> m_retired;
+            Snapshot m_staged;
+            int m_batchDepth;
+            bool m_rollingBack;
+
+            void publish(const Snapshot& changes);
+            void reclaim();
+
+            Q_DISABLE_COPY(ValueStore)
+        };
+
+        /**
+         * @brief The ValueBatch class opens a batch on a value store for as long as it is in scope.
+         * The batch is rolled back unless commit() is called, so an exception thrown part way through changing values
+         * leaves the store as it was and able to take the next batch.
+         */
+        class ValueBatch
+        {
+        public:
+            explicit ValueBatch( ValueStore& store );
+            ~ValueBatch();
+
+            void commit();
+
+        private:
+            ValueStore& m_store;
+            bool m_open;
+
+            Q_DISABLE_COPY(ValueBatch)
+        };
+    }
+}
+
+#endif // VALUESTORE_HPP
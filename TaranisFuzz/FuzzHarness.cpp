@@ -0,0 +1,209 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "FuzzHarness.hpp"
+#include "CommandLineInterface.hpp"
+#include "CommandLineInterfaceBuilder.hpp"
+#include "InputArgument.hpp"
+#include "InputArgumentKeyValuePair.hpp"
+#include <QSet>
+#include <QVariant>
+
+using namespace Taranis;
+using namespace Taranis::Fuzz;
+using namespace Taranis::Internal;
+
+const qint64 FuzzHarness::DEFAULTNANOSECONDSPERBYTE = 2000;
+const qint64 FuzzHarness::DEFAULTOVERHEADNANOSECONDS = 20000000;
+
+namespace
+{
+    // Every name starts with a different letter, and none with h or v, so a schema can never collide
+    // with itself or the built in arguments. Collisions are covered by the unit tests not the fuzzer.
+    const char* const OPTIONNAMES[] = { "address", "bind", "cache", "debug", "encoding", "force", "group", "input",
+                                        "jobs", "keep", "level", "mode", "name", "output", "port", "quiet" };
+    const int OPTIONNAMECOUNT = sizeof( OPTIONNAMES ) / sizeof( OPTIONNAMES[0] );
+    const char* const POSITIONALNAMES[] = { "source", "target" };
+    const int POSITIONALNAMECOUNT = sizeof( POSITIONALNAMES ) / sizeof( POSITIONALNAMES[0] );
+
+    /**
+     * @brief The FuzzCommandLineInterfaceBuilder class builds a CLI from the fuzzer's inputs rather than the
+     * application's, without needing a QCoreApplication.
+     */
+    class FuzzCommandLineInterfaceBuilder : public CommandLineInterfaceBuilder
+    {
+    public:
+        explicit FuzzCommandLineInterfaceBuilder(const QStringList& arguments) :
+            CommandLineInterfaceBuilder( QStringLiteral("Fuzz"), arguments )
+        {
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    bool isHelpRequest(const InputArgument& input)
+    {
+        // The help action prints and exits the process which would end the fuzzing session.
+        QString name = input.name().toLower();
+        return input.isValid() && ( ( name == QStringLiteral("help") ) || ( name == QStringLiteral("h") ) || ( name == QStringLiteral("?") ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+FuzzHarness::FuzzHarness(qint64 nanosecondsPerByte, qint64 overheadNanoseconds) :
+    m_nanosecondsPerByte( nanosecondsPerByte ),
+    m_overheadNanoseconds( overheadNanoseconds ),
+    m_executions( 0 ),
+    m_slowInputs( 0 ),
+    m_slowestNanosecondsPerByte( 0.0 )
+{
+    m_clock.start();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool FuzzHarness::run(const QByteArray& input)
+{
+    QElapsedTimer timer;
+    timer.start();
+    parse( input );
+    qint64 nanoseconds = timer.nsecsElapsed();
+
+    ++m_executions;
+    double nanosecondsPerByte = double( nanoseconds ) / double( input.size() + 1 );
+    if ( nanosecondsPerByte > m_slowestNanosecondsPerByte )
+    {
+        m_slowestNanosecondsPerByte = nanosecondsPerByte;
+    }
+
+    if ( isWithinLinearBound( nanoseconds, input.size() ) ) return true;
+
+    ++m_slowInputs;
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+void FuzzHarness::parse(const QByteArray& input) const
+{
+    const QStringList prefixes( { QStringLiteral("-"), QStringLiteral("--"), QStringLiteral("/") } );
+    QList<QByteArray> fields = input.split( '\0' );
+    QByteArray schema = fields.takeFirst();
+
+    QStringList arguments;
+    foreach( const QByteArray& field, fields )
+    {
+        QString token = QString::fromUtf8( field );
+
+        // Asking for completions prints them and exits, same as help.
+        if ( token == CommandLineInterface::COMPLETEARGUMENT ) continue;
+
+        InputArgument argument( token, prefixes );
+        if ( isHelpRequest( argument ) ) continue;
+        argument.value();
+        InputArgumentKeyValuePair pair( token );
+        pair.isValid();
+
+        arguments.append( token );
+    }
+
+    FuzzCommandLineInterfaceBuilder builder( arguments );
+    QSet<QString> usedNames;
+    bool hasPositionalList = false;
+    foreach( char byte, schema )
+    {
+        uchar selector = uchar( byte );
+        int index = selector / 5;
+        QString name;
+        switch ( selector % 5 )
+        {
+        case 0:
+            name = OPTIONNAMES[index % OPTIONNAMECOUNT];
+            if ( !usedNames.contains( name ) ) builder.WithFlag( name, QString() );
+            break;
+        case 1:
+            name = OPTIONNAMES[index % OPTIONNAMECOUNT];
+            if ( !usedNames.contains( name ) ) builder.WithValue( name, QString() );
+            break;
+        case 2:
+            name = OPTIONNAMES[index % OPTIONNAMECOUNT];
+            if ( !usedNames.contains( name ) ) builder.WithAction( name, QString(), [](QVariant) {} );
+            break;
+        case 3:
+            name = POSITIONALNAMES[index % POSITIONALNAMECOUNT];
+            if ( !usedNames.contains( name ) ) builder.WithPositional( name, QString() );
+            break;
+        default:
+            name = QStringLiteral("files");
+            if ( !hasPositionalList ) builder.WithPositionalList( name, QString() );
+            hasPositionalList = true;
+            break;
+        }
+        usedNames.insert( name );
+    }
+
+    CommandLineInterface cli = builder.getCommandLineInterface();
+    foreach( const QString& name, usedNames )
+    {
+        cli[name];
+    }
+    cli.positionalArguments().toStringList();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+bool FuzzHarness::isWithinLinearBound(qint64 nanoseconds, int bytes) const
+{
+    return nanoseconds <= ( m_nanosecondsPerByte * qint64( bytes ) ) + m_overheadNanoseconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 FuzzHarness::executions() const
+{
+    return m_executions;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+quint64 FuzzHarness::slowInputs() const
+{
+    return m_slowInputs;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+double FuzzHarness::executionsPerSecond() const
+{
+    qint64 elapsed = m_clock.nsecsElapsed();
+    return ( elapsed > 0 ) ? ( double( m_executions ) * 1e9 / double( elapsed ) ) : 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+double FuzzHarness::slowestNanosecondsPerByte() const
+{
+    return m_slowestNanosecondsPerByte;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+QString FuzzHarness::report() const
+{
+    return QString("%1 executions, %2 exec/s, %3 slow, slowest %4 ns/byte")
+            .arg( m_executions )
+            .arg( executionsPerSecond(), 0, 'f', 1 )
+            .arg( m_slowInputs )
+            .arg( m_slowestNanosecondsPerByte, 0, 'f', 1 );
+}
@@ -0,0 +1,90 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef FUZZHARNESS_HPP
+#define FUZZHARNESS_HPP
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+namespace Taranis
+{
+    namespace Fuzz
+    {
+        /**
+         * @brief The FuzzHarness class turns a fuzzer generated input into a schema and a command line and parses it.
+         * The input is split on null bytes, the first field picks the arguments of the schema, one byte per argument,
+         * and every other field is an input on the command line. Each input is also handed straight to InputArgument
+         * and InputArgumentKeyValuePair so the tokenizer is covered on its own.
+         *
+         * Every run is timed and compared against a bound which is linear in the size of the input so inputs which
+         * make the parser fall off a performance cliff are reported along with the ones which crash it.
+         *
+         * @code{.cpp}
+         * FuzzHarness harness;
+         * if ( !harness.run( input ) ) qWarning( "Slow input" );
+         * @endcode
+         */
+        class FuzzHarness
+        {
+        public:
+            static const qint64 DEFAULTNANOSECONDSPERBYTE;
+            static const qint64 DEFAULTOVERHEADNANOSECONDS;
+
+            explicit FuzzHarness(qint64 nanosecondsPerByte = DEFAULTNANOSECONDSPERBYTE, qint64 overheadNanoseconds = DEFAULTOVERHEADNANOSECONDS);
+
+            /**
+             * @brief run will parse the given input.
+             * @param input is the raw fuzzer input.
+             * @return Returns false if parsing took longer than the linear bound allows.
+             */
+            bool run(const QByteArray& input);
+
+            quint64 executions() const;
+            quint64 slowInputs() const;
+            double executionsPerSecond() const;
+            double slowestNanosecondsPerByte() const;
+
+            /**
+             * @brief report will describe the throughput so far.
+             * @return Returns a single line such as: 1024 executions, 5120.0 exec/s, 0 slow, slowest 310.2 ns/byte
+             */
+            QString report() const;
+
+        private:
+            qint64 m_nanosecondsPerByte;
+            qint64 m_overheadNanoseconds;
+            quint64 m_executions;
+            quint64 m_slowInputs;
+            double m_slowestNanosecondsPerByte;
+            QElapsedTimer m_clock;
+
+            void parse(const QByteArray& input) const;
+            bool isWithinLinearBound(qint64 nanoseconds, int bytes) const;
+        };
+    }
+}
+
+#endif // FUZZHARNESS_HPP
@@ -0,0 +1,32 @@
+QT += core
+QT -= gui
+
+TARGET = TaranisFuzz
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+# Without this the harness is a standalone replay binary, with it the harness is a libFuzzer target.
+# Build everything with clang and CONFIG+=taranis_libfuzzer so Taranis is instrumented as well.
+taranis_libfuzzer {
+    DEFINES += TARANIS_LIBFUZZER
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer,address
+    QMAKE_LFLAGS += -fsanitize=fuzzer,address
+}
+
+HEADERS += \
+    FuzzHarness.hpp
+
+SOURCES += main.cpp \
+    FuzzHarness.cpp
+
+## TARANIS ############################################################################
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../Taranis/release/ -lTaranis
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../Taranis/debug/ -lTaranis
+else:unix: LIBS += -L$$OUT_PWD/../Taranis/ -lTaranis
+
+INCLUDEPATH += $$PWD/../Taranis $$PWD/../Taranis/internal
+DEPENDPATH += $$PWD/../Taranis
+#######################################################################################
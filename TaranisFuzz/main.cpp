@@ -0,0 +1,142 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "FuzzHarness.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Taranis::Fuzz;
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    qint64 nanosecondsPerByteBound()
+    {
+        bool ok( false );
+        qint64 bound = qgetenv( "TARANIS_FUZZ_NS_PER_BYTE" ).toLongLong( &ok );
+        return ok ? bound : FuzzHarness::DEFAULTNANOSECONDSPERBYTE;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    void silenceMessages(QtMsgType, const QMessageLogContext&, const QString&)
+    {
+        // Overriding built in arguments warns on every run, which would drown out the fuzzer's own output.
+    }
+}
+
+#ifdef TARANIS_LIBFUZZER
+
+/**
+ * libFuzzer entry point. Build with CONFIG+=taranis_libfuzzer and run it as:
+ *
+ *    TaranisFuzz -detect_leaks=0 corpus/
+ *
+ * An input which takes longer than the linear bound aborts so libFuzzer saves it like any other crash.
+ * The bound can be changed with the TARANIS_FUZZ_NS_PER_BYTE environment variable.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static FuzzHarness harness( nanosecondsPerByteBound() );
+    static bool initialized = ( qInstallMessageHandler( silenceMessages ), true );
+    Q_UNUSED( initialized );
+
+    QByteArray input = QByteArray::fromRawData( reinterpret_cast<const char*>( data ), int( size ) );
+    if ( !harness.run( input ) )
+    {
+        fprintf( stderr, "Parse time exceeded the linear bound for a %d byte input\n", input.size() );
+        abort();
+    }
+
+    if ( ( harness.executions() & ( harness.executions() - 1 ) ) == 0 )
+    {
+        fprintf( stderr, "TaranisFuzz: %s\n", qPrintable( harness.report() ) );
+    }
+    return 0;
+}
+
+#else
+
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include "CommandLineInterface.hpp"
+
+/**
+ * Standalone replay binary, each file given, or every file in each directory given, is run through the
+ * harness once. Use it to reproduce a crash or slow input saved by libFuzzer without the fuzzer.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app( argc, argv );
+
+    int nanosecondsPerByte = int( nanosecondsPerByteBound() );
+    int repeat = 1;
+    Taranis::CommandLineInterface cli = Taranis::CommandLineInterface::build()
+            .WithName( "TaranisFuzz" )
+            .WithDescription( "Replays fuzzer inputs through the Taranis tokenizer and parser." )
+            .WithValue( "ns-per-byte", "Parse time allowed per input byte before an input is reported as slow.", &nanosecondsPerByte )
+            .WithValue( "repeat", "Number of times to run each input.", &repeat )
+            .WithPositionalList( "inputs", "Input files, or directories of input files, to replay." );
+
+    QStringList files;
+    for ( const QString& path : cli.positional( "inputs" ) )
+    {
+        if ( QFileInfo( path ).isDir() )
+        {
+            QDirIterator it( path, QDir::Files, QDirIterator::Subdirectories );
+            while ( it.hasNext() ) files.append( it.next() );
+        }
+        else
+        {
+            files.append( path );
+        }
+    }
+
+    qInstallMessageHandler( silenceMessages );
+    FuzzHarness harness( nanosecondsPerByte );
+    foreach( const QString& path, files )
+    {
+        QFile file( path );
+        if ( !file.open( QIODevice::ReadOnly ) )
+        {
+            fprintf( stderr, "Unable to read %s\n", qPrintable( path ) );
+            continue;
+        }
+
+        QByteArray input = file.readAll();
+        for ( int i = 0; i < repeat; ++i )
+        {
+            if ( !harness.run( input ) )
+            {
+                fprintf( stderr, "Slow: %s (%d bytes)\n", qPrintable( path ), input.size() );
+            }
+        }
+    }
+
+    printf( "%s\n", qPrintable( harness.report() ) );
+    return ( harness.slowInputs() == 0 ) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Brad van der Laan
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef ALLOCATIONTRACKER_HPP
+#define ALLOCATIONTRACKER_HPP
+
+#include <QtGlobal>
+
+namespace Taranis
+{
+    namespace UnitTest
+    {
+        /**
+         * @brief The AllocationTracker class counts the heap allocations made while it is running.
+         * It reads the AllocationCounter of Taranis, which the test binary always compiles in with counting turned on.
+         *
+         * @code{.cpp}
+         * AllocationTracker tracker;
+         * cli["server"];
+         * QVERIFY( tracker.allocations() <= 1 );
+         * @endcode
+         */
+        class AllocationTracker
+        {
+        public:
+            AllocationTracker();
+
+            void restart();
+            quint64 allocations() const;
+            quint64 bytes() const;
+
+        private:
+            quint64 m_allocations;
+            quint64 m_bytes;
+        };
+    }
+}
+
+#endif // ALLOCATIONTRACKER_HPP
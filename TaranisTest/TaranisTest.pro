@@ -8,13 +8,20 @@ CONFIG -= app_bundle
 
 TEMPLATE = app
 
+# The allocation budget tests always count. The counter of Taranis is compiled in with counting turned on, it
+# takes the place of the one in the library so the counter and its operator new only exist once.
+DEFINES += TARANIS_COUNT_ALLOCATIONS
+
 HEADERS += \
     TaranisTestSuite.hpp \
+    AllocationTracker.hpp \
     QVerifyNoExceptionThrown.hpp \
     QVerifyExceptionThrown.hpp
     
 SOURCES += main.cpp \
-    TaranisTestSuite.cpp
+    TaranisTestSuite.cpp \
+    AllocationTracker.cpp \
+    ../Taranis/internal/AllocationCounter.cpp
 
 ## TARANIS ############################################################################
 win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../Taranis/release/ -lTaranis
@@ -24,11 +24,29 @@
 
 #include <QTest>
 #include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QException>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "AllocationTracker.hpp"
 #include "QVerifyExceptionThrown.hpp" // For Qt 5.2.x and lower
 #include "QVerifyNoExceptionThrown.hpp"
 #include "TaranisTestSuite.hpp"
 #include "CommandLineInterface.hpp"
 #include "InputArgument.hpp"
+#include "Argument.hpp"
+#include "ChoiceTable.hpp"
+#include "ArgumentValidator.hpp"
 #include "TaranisExceptions.hpp"
 
 using namespace Taranis::UnitTest;
@@ -41,6 +59,40 @@ TaranisTestSuite::TaranisTestSuite(QObject *parent) : QObject(parent)
     m_executableName = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
 }
 
+/////////////////////////////////////////////////////////////////////////////
+QString TaranisTestSuite::writeFile(const QString& path, const QByteArray& contents) const
+{
+    QFile file( path );
+    file.open( QIODevice::WriteOnly );
+    file.write( contents );
+    return path;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+Taranis::CommandLineInterfaceBuilder& TaranisTestSuite::addRepresentativeSchema(CommandLineInterfaceBuilder& builder) const
+{
+    return builder.WithValue("address", "Address of the device.")
+                  .WithValue("bind", "Interface to bind to.")
+                  .WithValue("cache", "Cache directory.")
+                  .WithFlag("debug", "Enables debug mode.")
+                  .WithValue("encoding", "Text encoding.")
+                  .WithFlag("force", "Forces a refresh.")
+                  .WithValue("group", "Group to run as.")
+                  .WithValue("input", "Input file.")
+                  .WithValue("jobs", "Number of jobs.")
+                  .WithFlag("keep", "Keeps temporary files.")
+                  .WithValue("level", "Log level.")
+                  .WithValue("mode", "Operating mode.")
+                  .WithValue("name", "Name of the session.")
+                  .WithValue("output", "Output file.")
+                  .WithValue("port", "Port to connect to.")
+                  .WithFlag("quiet", "Suppresses output.")
+                  .WithValue("retries", "Number of retries.")
+                  .WithValue("server", "Server to connect to.")
+                  .WithValue("timeout", "Timeout in seconds.")
+                  .WithValue("user", "User to run as.");
+}
+
 /////////////////////////////////////////////////////////////////////////////
 void TaranisTestSuite::testSetName()
 {
@@ -890,6 +942,2465 @@ void TaranisTestSuite::testActionWithValue()
     QCOMPARE( listActionValue.toString(), QStringLiteral("") );
 }
 
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueFromIniConfigFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "; settings\nServer = 10.0.0.1\nport=8080\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "127.0.0.1", "The server address.")
+            .WithConfigFile(path);
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("10.0.0.1") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueFromIniConfigFileSection()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "[General]\nmode=fast\n[db]\nhost = \"db.local\"\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("mode", "The mode.")
+            .WithValue("db.host", "The database host.")
+            .WithConfigFile(path);
+
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("fast") );
+    QCOMPARE( cli["db.host"].toString(), QStringLiteral("db.local") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueFromJsonConfigFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.json", "{ \"Server\": \"10.0.0.1\", \"db\": { \"port\": 5432 } }" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "127.0.0.1", "The server address.")
+            .WithValue("db.port", "The database port.")
+            .WithConfigFile(path);
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("10.0.0.1") );
+    QCOMPARE( cli["db.port"].toString(), QStringLiteral("5432") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLargeNumberFromJsonConfigFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.json", "{ \"limit\": 1234567, \"ratio\": 0.1, \"scale\": 2.5e-7 }" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("limit", "The request limit.")
+            .WithValue("ratio", "The sample ratio.")
+            .WithValue("scale", "The scale factor.")
+            .WithConfigFile(path);
+
+    QCOMPARE( cli["limit"].toString(), QStringLiteral("1234567") );
+    QCOMPARE( cli["ratio"].toString(), QStringLiteral("0.1") );
+    QCOMPARE( cli["scale"].toString().toDouble(), 2.5e-7 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testFlagFromConfigFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "debug=yes\nmouse=false\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithFlag("mouse", "Force mouse to be displayed.")
+            .WithConfigFile(path);
+
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli["mouse"].toBool(), false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConfigFileOverriddenByCommandLine()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "server=10.0.0.1\n" );
+
+    int callCount(0);
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4"})
+            .WithValue("server", "The server address.", [&callCount](QVariant value) {
+                QCOMPARE( value.toString(), QStringLiteral("1.2.3.4") );
+                callCount++;
+            })
+            .WithConfigFile(path);
+
+    QCOMPARE( callCount, 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConfigFileOverriddenByEnvironment()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "log-level=info\n" );
+    qputenv( "TARANISTEST_LOG_LEVEL", "debug" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("log-level", "warn", "The log level.")
+            .WithConfigFile(path)
+            .WithEnvironment("TARANISTEST");
+
+    qunsetenv( "TARANISTEST_LOG_LEVEL" );
+    QCOMPARE( cli["log-level"].toString(), QStringLiteral("debug") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLaterConfigFileOverridesEarlierOne()
+{
+    QTemporaryDir dir;
+    QString systemPath = writeFile( dir.path() + "/system.ini", "server=10.0.0.1\nmode=fast\n" );
+    QString userPath = writeFile( dir.path() + "/user.ini", "server=10.0.0.2\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "The server address.")
+            .WithValue("mode", "The mode.")
+            .WithConfigFile(systemPath)
+            .WithConfigFile(userPath);
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("10.0.0.2") );
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("fast") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMissingConfigFileIsIgnored()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "127.0.0.1", "The server address.")
+            .WithConfigFile("/this/file/does/not/exist.ini");
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("127.0.0.1") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationAppliesChangedValues()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "server=10.0.0.1\nmode=fast\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "The server address.")
+            .WithValue("mode", "The mode.")
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    writeFile( path, "server=10.0.0.2\nmode=fast\n" );
+
+    QCOMPARE( cli.reloadConfiguration(), QStringList({"server"}) );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("10.0.0.2") );
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("fast") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationOnlyExecutesChangedActions()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "rate=10\nmode=fast\n" );
+
+    int rateCallCount(0);
+    int modeCallCount(0);
+    QVariant rate;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("rate", "The rate limit.", [&](QVariant value) {
+                rate = value;
+                rateCallCount++;
+            })
+            .WithValue("mode", "The mode.", [&](QVariant) {
+                modeCallCount++;
+            })
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    writeFile( path, "rate=20\nmode=fast\n" );
+    cli.reloadConfiguration();
+
+    QCOMPARE( rateCallCount, 2 );
+    QCOMPARE( modeCallCount, 1 );
+    QCOMPARE( rate.toString(), QStringLiteral("20") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationKeepsCommandLineValues()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "server=10.0.0.1\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4"})
+            .WithValue("server", "The server address.")
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    writeFile( path, "server=10.0.0.2\n" );
+
+    QCOMPARE( cli.reloadConfiguration().isEmpty(), true );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationRevertsRemovedValuesToDefault()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "server=10.0.0.1\ndebug=true\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "127.0.0.1", "The server address.")
+            .WithFlag("debug", "Enables debug mode.")
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    QCOMPARE( cli["debug"].toBool(), true );
+
+    writeFile( path, "" );
+    cli.reloadConfiguration();
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("127.0.0.1") );
+    QCOMPARE( cli["debug"].toBool(), false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationRejectsInvalidValues()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "port=8080\nmode=fast\n" );
+
+    int portCallCount(0);
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("port", "The port to listen on.", [&](QVariant) { portCallCount++; })
+            .WithValue("mode", "The mode.")
+            .WithRange("port", 1, 65535)
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    writeFile( path, "port=0\nmode=slow\n" );
+
+    QVERIFY_EXCEPTION_THROWN( cli.reloadConfiguration(), ValidationException );
+    QCOMPARE( portCallCount, 1 );
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("fast") );
+
+    writeFile( path, "port=8081\nmode=slow\n" );
+
+    QCOMPARE( cli.reloadConfiguration(), QStringList({"mode", "port"}) );
+    QCOMPARE( portCallCount, 2 );
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("slow") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationRejectsInvalidChoice()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "log-level=warn\nmode=fast\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithChoice("log-level", {"debug", "info", "warn"}, "info", "Sets how much is logged.")
+            .WithValue("mode", "The mode.")
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    QCOMPARE( cli["log-level"], QVariant( 2 ) );
+
+    writeFile( path, "log-level=verbose\nmode=slow\n" );
+
+    QVERIFY_EXCEPTION_THROWN( cli.reloadConfiguration(), ValidationException );
+    QCOMPARE( cli["log-level"], QVariant( 2 ) );
+    QCOMPARE( cli["mode"].toString(), QStringLiteral("fast") );
+
+    writeFile( path, "log-level=debug\nmode=slow\n" );
+
+    QCOMPARE( cli.reloadConfiguration(), QStringList({"log-level", "mode"}) );
+    QCOMPARE( cli["log-level"], QVariant( 0 ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testReloadConfigurationWithoutWatchingDoesNothing()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "server=10.0.0.1\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("server", "The server address.")
+            .WithConfigFile(path);
+
+    writeFile( path, "server=10.0.0.2\n" );
+
+    QCOMPARE( cli.reloadConfiguration().isEmpty(), true );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("10.0.0.1") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSetValueChangesValue()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4"})
+            .WithValue("server", "The server address.");
+
+    cli.setValue("Server", "5.6.7.8");
+    QCOMPARE( cli["server"].toString(), QStringLiteral("5.6.7.8") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSetValueIsSharedBetweenCopies()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithFlag("debug", "Enables debug mode.");
+    CommandLineInterface copy = cli;
+
+    cli.setValue("debug", true);
+    QCOMPARE( copy["debug"].toBool(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConcurrentReadsWhileSettingValues()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--mode=slow"})
+            .WithValue("mode", "The mode.");
+
+    std::atomic<bool> done( false );
+    std::atomic<int> badReads( 0 );
+    std::vector<std::thread> readers;
+    for ( int i = 0; i < 4; ++i )
+    {
+        readers.push_back( std::thread( [&]() {
+            while ( !done )
+            {
+                QString mode = cli["mode"].toString();
+                if ( ( mode != QStringLiteral("slow") ) && ( mode != QStringLiteral("fast") ) ) badReads++;
+            }
+        }));
+    }
+
+    for ( int i = 0; i < 10000; ++i )
+    {
+        cli.setValue( "mode", ( i % 2 ) ? QStringLiteral("slow") : QStringLiteral("fast") );
+    }
+
+    done = true;
+    for ( auto& reader : readers ) reader.join();
+
+    QCOMPARE( badReads.load(), 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConcurrentReadsOfBoundValue()
+{
+    QString mode = QStringLiteral("slow");
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("mode", "The mode.", &mode);
+
+    std::atomic<bool> done( false );
+    std::atomic<int> badReads( 0 );
+    std::vector<std::thread> readers;
+    for ( int i = 0; i < 4; ++i )
+    {
+        readers.push_back( std::thread( [&]() {
+            while ( !done )
+            {
+                QString read = cli["mode"].toString();
+                if ( ( read != QStringLiteral("slow") ) && ( read != QStringLiteral("fast") ) ) badReads++;
+            }
+        }));
+    }
+
+    for ( int i = 0; i < 10000; ++i )
+    {
+        cli.setValue( "mode", ( i % 2 ) ? QStringLiteral("slow") : QStringLiteral("fast") );
+    }
+
+    done = true;
+    for ( auto& reader : readers ) reader.join();
+
+    QCOMPARE( badReads.load(), 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCommandSelected()
+{
+    bool deployBuilt(false);
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"build", "--jobs=8"})
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+                build.WithValue("jobs", "1", "Number of parallel jobs.");
+            })
+            .WithCommand("deploy", "Deploys the project.", [&deployBuilt](CommandLineInterfaceBuilder& deploy) {
+                deployBuilt = true;
+                deploy.WithValue("target", "Where to deploy to.");
+            });
+
+    QCOMPARE( cli.command(), QStringLiteral("build") );
+    QCOMPARE( cli["jobs"].toString(), QStringLiteral("8") );
+    QCOMPARE( cli["target"].isValid(), false );
+    QCOMPARE( deployBuilt, false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCommandNotSelected()
+{
+    bool buildBuilt(false);
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--verbose"})
+            .WithFlag("verbose", "Enables verbose logging.")
+            .WithCommand("build", "Builds the project.", [&buildBuilt](CommandLineInterfaceBuilder&) {
+                buildBuilt = true;
+            });
+
+    QCOMPARE( cli.command(), QStringLiteral("") );
+    QCOMPARE( cli["verbose"].toBool(), true );
+    QCOMPARE( buildBuilt, false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCommandAfterGlobalOption()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--verbose", "deploy", "--target", "prod"})
+            .WithFlag("verbose", "Enables verbose logging.")
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+                build.WithValue("jobs", "1", "Number of parallel jobs.");
+            })
+            .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder& deploy) {
+                deploy.WithValue("target", "Where to deploy to.");
+            });
+
+    QCOMPARE( cli.command(), QStringLiteral("deploy") );
+    QCOMPARE( cli["verbose"].toBool(), true );
+    QCOMPARE( cli["target"].toString(), QStringLiteral("prod") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCommandAfterGlobalOptionValue()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--jobs", "8", "--verbose", "build", "release"})
+            .WithValue("jobs", "1", "Number of parallel jobs.")
+            .WithFlag("verbose", "Log everything.")
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+                build.WithPositional("config", "The configuration to build.");
+            })
+            .WithCommand("8", "Never selected.", [](CommandLineInterfaceBuilder&) {});
+
+    QCOMPARE( cli.command(), QStringLiteral("build") );
+    QCOMPARE( cli["jobs"].toString(), QStringLiteral("8") );
+    QCOMPARE( cli["verbose"].toBool(), true );
+    QCOMPARE( cli["config"].toString(), QStringLiteral("release") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCommandCaseInsensative()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"BUILD"})
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder&) {});
+
+    QCOMPARE( cli.command(), QStringLiteral("build") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNestedCommand()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"remote", "add", "--url=http://example.com"})
+            .WithCommand("remote", "Manages remotes.", [](CommandLineInterfaceBuilder& remote) {
+                remote.WithCommand("add", "Adds a remote.", [](CommandLineInterfaceBuilder& add) {
+                          add.WithValue("url", "The remote's address.");
+                      })
+                      .WithCommand("remove", "Removes a remote.", [](CommandLineInterfaceBuilder&) {});
+            })
+            .WithCommand("add", "Adds a file.", [](CommandLineInterfaceBuilder&) {});
+
+    QCOMPARE( cli.command(), QStringLiteral("remote add") );
+    QCOMPARE( cli["url"].toString(), QStringLiteral("http://example.com") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpMessageWithCommands()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("MyApp", {})
+            .WithName("MyApp")
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder&) {})
+            .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder&) {});
+
+    QString expected = QString("MyApp\n"
+                       "=====\n"
+                       "Usage: %1 [OPTION] COMMAND\n\n"
+                       "  -?\tDisplay this help and exit\n"
+                       "  -h, --help\tDisplay this help and exit\n"
+                       "\nCommands:\n"
+                       "  build\tBuilds the project.\n"
+                       "  deploy\tDeploys the project.\n").arg(m_executableName);
+
+    QCOMPARE( cli.helpMessage(), expected );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpMessageForSelectedCommand()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("MyApp", {"build"})
+            .WithName("MyApp")
+            .WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+                build.WithValue("jobs", "1", "Number of parallel jobs.");
+            })
+            .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder&) {});
+
+    QString expected = QString("MyApp\n"
+                       "=====\n"
+                       "Usage: %1 build [OPTION]\n\n"
+                       "  -?\tDisplay this help and exit\n"
+                       "  -h, --help\tDisplay this help and exit\n"
+                       "  -j, --jobs\tNumber of parallel jobs.\n").arg(m_executableName);
+
+    QCOMPARE( cli.helpMessage(), expected );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPositionalArguments()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"a.txt", "--server=1.2.3.4", "b.txt", "-"})
+            .WithValue("server", "The server IP address.")
+            .WithPositionalList("files", "The files to process.");
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+    QCOMPARE( cli.positional("files").toStringList(), QStringList({"a.txt", "b.txt", "-"}) );
+    QCOMPARE( cli["FILES"].toStringList(), QStringList({"a.txt", "b.txt", "-"}) );
+    QCOMPARE( cli.positionalArguments().count(), 3 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testFlagDoesNotConsumePositionalArgument()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug", "a.txt", "--server", "1.2.3.4"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithValue("server", "The server IP address.")
+            .WithPositional("input", "The file to process.");
+
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+    QCOMPARE( cli["input"].toString(), QStringLiteral("a.txt") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testEndOfOptionsMarker()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug", "--", "--server=1.2.3.4", "-d", "--"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithValue("server", "127.0.0.1", "The server IP address.")
+            .WithPositionalList("files", "The files to process.");
+
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("127.0.0.1") );
+    QCOMPARE( cli.positional("files").toStringList(), QStringList({"--server=1.2.3.4", "-d", "--"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPositionalListWithTrailingPositional()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"a.txt", "b.txt", "c.txt", "out"})
+            .WithPositionalList("sources", "The files to copy.")
+            .WithPositional("destination", "Where to copy the files to.");
+
+    QCOMPARE( cli.positional("sources").toStringList(), QStringList({"a.txt", "b.txt", "c.txt"}) );
+    QCOMPARE( cli["destination"].toString(), QStringLiteral("out") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMissingPositionalArgument()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"a.txt"})
+            .WithPositional("source", "The file to copy.")
+            .WithPositional("destination", "Where to copy the file to.");
+
+    QCOMPARE( cli["source"].toString(), QStringLiteral("a.txt") );
+    QCOMPARE( cli["destination"].isValid(), false );
+    QCOMPARE( cli.positional("destination").isEmpty(), true );
+    QCOMPARE( cli.positional("missing").isEmpty(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPositionalSpanDoesNotCopyInputs()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug", "--", "a.txt", "b.txt"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithPositionalList("files", "The files to process.");
+
+    ArgumentSpan files = cli.positional("files");
+    QCOMPARE( files.count(), 2 );
+    QCOMPARE( files.at(0).constData(), cli.m_inputArguments.at(2).constData() );
+    QCOMPARE( files.at(1).constData(), cli.m_inputArguments.at(3).constData() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLargePositionalList()
+{
+    QStringList inputs( {"--debug", "--"} );
+    for ( int i = 0; i < 200000; ++i )
+    {
+        inputs.append( QString("file%1.cpp").arg(i) );
+    }
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", inputs)
+            .WithFlag("debug", "Enables debug mode.")
+            .WithPositionalList("files", "The files to process.");
+
+    ArgumentSpan files = cli.positional("files");
+    QCOMPARE( files.count(), 200000 );
+    QCOMPARE( files.at(0), QStringLiteral("file0.cpp") );
+    QCOMPARE( files.at(199999), QStringLiteral("file199999.cpp") );
+
+    int count = 0;
+    for ( const QString& file : files )
+    {
+        Q_UNUSED( file );
+        ++count;
+    }
+    QCOMPARE( count, 200000 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDefiningTwoPositionalListsThrows()
+{
+    QVERIFY_EXCEPTION_THROWN(CommandLineInterfaceBuilder("My Cool App", {})
+            .WithPositionalList("sources", "The files to compile.")
+            .WithPositionalList("headers", "The headers to include."), PositionalListRedefinitionException);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpMessageWithPositionalArguments()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("MyApp", {})
+            .WithName("MyApp")
+            .WithPositionalList("sources", "The files to copy.")
+            .WithPositional("destination", "Where to copy the files to.");
+
+    QString expected = QString("MyApp\n"
+                       "=====\n"
+                       "Usage: %1 [OPTION] SOURCES... DESTINATION\n\n"
+                       "  -?\tDisplay this help and exit\n"
+                       "  -h, --help\tDisplay this help and exit\n"
+                       "\nArguments:\n"
+                       "  SOURCES\tThe files to copy.\n"
+                       "  DESTINATION\tWhere to copy the files to.\n").arg(m_executableName);
+
+    QCOMPARE( cli.helpMessage(), expected );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testFlagBoundToVariable()
+{
+    bool debug = false;
+    bool verbose = false;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.", &debug)
+            .WithFlag("verbose", "Enables verbose logging.", &verbose);
+
+    QCOMPARE( debug, true );
+    QCOMPARE( verbose, false );
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli["verbose"].toBool(), false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueBoundToInt()
+{
+    int port = 8080;
+    int jobs = 1;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--port", "9000"})
+            .WithValue("port", "The port to listen on.", &port)
+            .WithValue("jobs", "Number of parallel jobs.", &jobs);
+
+    QCOMPARE( port, 9000 );
+    QCOMPARE( jobs, 1 );
+    QCOMPARE( cli["port"].toInt(), 9000 );
+
+    cli.setValue( "jobs", 4 );
+    QCOMPARE( jobs, 4 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueBoundToIntWithInvalidInput()
+{
+    int port = 8080;
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterfaceBuilder("My Cool App", {"--port=abc"})
+            .WithValue("port", "The port to listen on.", &port)
+            .getCommandLineInterface(), ValidationException );
+
+    QCOMPARE( port, 8080 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueBoundToDoubleAndString()
+{
+    double ratio = 0.5;
+    QString host( "localhost" );
+    CommandLineInterfaceBuilder("My Cool App", {"--ratio=0.75", "--address:example.com"})
+            .WithValue("ratio", "The compression ratio.", &ratio)
+            .WithValue("address", "The host to connect to.", &host)
+            .getCommandLineInterface();
+
+    QCOMPARE( ratio, 0.75 );
+    QCOMPARE( host, QStringLiteral("example.com") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testValueBoundToProperty()
+{
+    QObject object;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--name=Fred"})
+            .WithValue("name", "The name of the object.", &object, "objectName");
+
+    QCOMPARE( object.objectName(), QStringLiteral("Fred") );
+    QCOMPARE( cli["name"].toString(), QStringLiteral("Fred") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testBoundValueFromConfigFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/app.ini", "port=9000\ndebug=yes\n" );
+
+    int port = 8080;
+    bool debug = false;
+    CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("port", "The port to listen on.", &port)
+            .WithFlag("debug", "Enables debug mode.", &debug)
+            .WithConfigFile(path)
+            .getCommandLineInterface();
+
+    QCOMPARE( port, 9000 );
+    QCOMPARE( debug, true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDeferredActionsRunInPriorityOrder()
+{
+    QStringList executed;
+    CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4", "--log=app.log"})
+            .WithValue("server", "The server IP address.", [&](QVariant) { executed.append("server"); })
+            .WithValue("log", "The log file.", [&](QVariant) { executed.append("log"); })
+            .WithPriority("log", 10)
+            .WithDeferredActions()
+            .getCommandLineInterface();
+
+    QCOMPARE( executed, QStringList({"log", "server"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDeferredActionsWithEqualPriorityKeepTheirOrder()
+{
+    QStringList executed;
+    CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4", "--log=app.log", "--debug"})
+            .WithValue("log", "The log file.", [&](QVariant) { executed.append("log"); })
+            .WithValue("server", "The server IP address.", [&](QVariant) { executed.append("server"); })
+            .WithFlag("debug", "Enables debug mode.", [&](QVariant) { executed.append("debug"); })
+            .WithPriority("debug", -1)
+            .WithDeferredActions()
+            .getCommandLineInterface();
+
+    QCOMPARE( executed, QStringList({"server", "log", "debug"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPriorityIgnoredWhenActionsAreNotDeferred()
+{
+    QStringList executed;
+    CommandLineInterfaceBuilder("My Cool App", {"--server=1.2.3.4", "--log=app.log"})
+            .WithValue("server", "The server IP address.", [&](QVariant) { executed.append("server"); })
+            .WithValue("log", "The log file.", [&](QVariant) { executed.append("log"); })
+            .WithPriority("log", 10)
+            .getCommandLineInterface();
+
+    QCOMPARE( executed, QStringList({"server", "log"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDeferredActionsRunAfterValuesAreStored()
+{
+    QVariant seenAddress;
+
+    CommandLineInterfaceBuilder builder("My Cool App", {"--log=app.log", "--address=1.2.3.4"});
+    builder.WithValue("log", "The log file.", [&](QVariant) { seenAddress = (*builder.m_cli)["address"]; })
+           .WithValue("address", "The server IP address.")
+           .WithDeferredActions()
+           .getCommandLineInterface();
+
+    QCOMPARE( seenAddress.toString(), QStringLiteral("1.2.3.4") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDeferredActionsWaitForTheirDependencies()
+{
+    QStringList executed;
+    CommandLineInterfaceBuilder("My Cool App", {"--cache", "--database=db.local", "--log=app.log"})
+            .WithFlag("cache", "Warms the cache.", [&](QVariant) { executed.append("cache"); })
+            .WithValue("database", "The database to connect to.", [&](QVariant) { executed.append("database"); })
+            .WithValue("log", "The log file.", [&](QVariant) { executed.append("log"); })
+            .WithPriority("cache", 10)
+            .WithDependency("cache", "database")
+            .WithDeferredActions()
+            .getCommandLineInterface();
+
+    QCOMPARE( executed, QStringList({"database", "cache", "log"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCircularDependencyThrows()
+{
+    QVERIFY_EXCEPTION_THROWN(CommandLineInterfaceBuilder("My Cool App", {})
+            .WithFlag("cache", "Warms the cache.")
+            .WithFlag("database", "Opens the database.")
+            .WithFlag("model", "Loads the model.")
+            .WithDependency("cache", "database")
+            .WithDependency("database", "model")
+            .WithDependency("model", "cache"), CircularDependencyException);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testAsyncActionsRunConcurrently()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount( 2 );
+
+    // Each action waits for the other to start, which only works if they run at the same time.
+    std::atomic<int> started( 0 );
+    std::atomic<int> metEachOther( 0 );
+    auto action = [&](QVariant) {
+        ++started;
+        QElapsedTimer timer;
+        timer.start();
+        while ( ( started.load() < 2 ) && ( timer.elapsed() < 5000 ) ) QThread::msleep( 1 );
+        if ( started.load() == 2 ) ++metEachOther;
+    };
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--cache", "--model"})
+            .WithAction("cache", "Warms the cache.", action)
+            .WithAction("model", "Loads the model.", action)
+            .WithAsyncActions( &pool );
+
+    cli.actionsFinished().waitForFinished();
+    QCOMPARE( metEachOther.load(), 2 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testAsyncActionsWaitForTheirDependencies()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount( 4 );
+
+    std::atomic<bool> databaseOpen( false );
+    std::atomic<bool> cacheSawDatabase( false );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--cache", "--database=db.local"})
+            .WithAction("cache", "Warms the cache.", [&](QVariant) { cacheSawDatabase = databaseOpen.load(); })
+            .WithValue("database", "The database to connect to.", [&](QVariant) {
+                QThread::msleep( 50 );
+                databaseOpen = true;
+            })
+            .WithDependency("cache", "database")
+            .WithAsyncActions( &pool );
+
+    cli.actionsFinished().waitForFinished();
+    QCOMPARE( databaseOpen.load(), true );
+    QCOMPARE( cacheSawDatabase.load(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testActionsFinishedWhenNotAsync()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.", [](QVariant) {});
+
+    QCOMPARE( cli.actionsFinished().isFinished(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testFailingAsyncActionStillFinishes()
+{
+    QThreadPool pool;
+    std::atomic<bool> cacheWarmed( false );
+
+    QTest::ignoreMessage( QtWarningMsg, "The action of database failed: Connection refused" );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--cache", "--database=db.local"})
+            .WithAction("cache", "Warms the cache.", [&](QVariant) { cacheWarmed = true; })
+            .WithValue("database", "The database to connect to.", [](QVariant) { throw std::runtime_error( "Connection refused" ); })
+            .WithDependency("cache", "database")
+            .WithAsyncActions( &pool );
+
+    QVERIFY_EXCEPTION_THROWN( cli.actionsFinished().waitForFinished(), QUnhandledException );
+    pool.waitForDone();
+    QCOMPARE( cli.actionsFinished().isFinished(), true );
+    QCOMPARE( cacheWarmed.load(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testVersionActionRunsOnCallingThread()
+{
+    QThreadPool pool;
+    QThread* versionThread = nullptr;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--version", "--debug"})
+            .WithVersion("1.2.3.4", [&versionThread](QVariant) { versionThread = QThread::currentThread(); })
+            .WithFlag("debug", "Enables debug mode.", [](QVariant) {})
+            .WithAsyncActions(&pool);
+
+    QCOMPARE( versionThread, QThread::currentThread() );
+    cli.actionsFinished().waitForFinished();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testStatisticsRecordedWhenEnabled()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug", "--server=1.2.3.4"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithValue("server", "The server IP address.")
+            .WithStatistics();
+
+    ParseStatistics statistics = cli.statistics();
+    QCOMPARE( statistics.count( ParseStatistics::Registration ), 1 );
+    QCOMPARE( statistics.count( ParseStatistics::Tokenization ), 1 );
+    QCOMPARE( statistics.count( ParseStatistics::Lookup ), 2 );
+    QCOMPARE( statistics.count( ParseStatistics::Configuration ), 1 );
+    QCOMPARE( statistics.count( ParseStatistics::Callbacks ), 1 );
+    QCOMPARE( statistics.count( ParseStatistics::Help ), 0 );
+    QVERIFY( statistics.elapsed( ParseStatistics::Registration ) > 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testStatisticsEmptyWhenNotEnabled()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.");
+
+    QCOMPARE( cli.statistics().count( ParseStatistics::Tokenization ), 0 );
+    QCOMPARE( cli.statistics().elapsed( ParseStatistics::Tokenization ), qint64( 0 ) );
+    QCOMPARE( cli["taranis-stats"].isValid(), false );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testStatisticsArgumentIsHidden()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("MyApp", {})
+            .WithName("MyApp")
+            .WithValue("timeout", "The timeout in seconds.")
+            .WithStatistics();
+
+    QString expected = QString("MyApp\n"
+                       "=====\n"
+                       "Usage: %1 [OPTION]\n\n"
+                       "  -?\tDisplay this help and exit\n"
+                       "  -h, --help\tDisplay this help and exit\n"
+                       "  -t, --timeout\tThe timeout in seconds.\n").arg(m_executableName);
+
+    QCOMPARE( cli.helpMessage(), expected );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpRenderingIsRecorded()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithStatistics();
+
+    cli.helpMessage();
+    cli.helpMessage();
+    QCOMPARE( cli.statistics().count( ParseStatistics::Help ), 2 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testStatisticsAsJson()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithStatistics();
+
+    QJsonObject json = QJsonDocument::fromJson( cli.statistics().toJson() ).object();
+    QCOMPARE( json["allocationCounting"].toBool(), ParseStatistics::isCountingAllocations() );
+    QCOMPARE( json["phases"].toObject()["tokenization"].toObject()["count"].toInt(), 1 );
+    QCOMPARE( json["phases"].toObject()["lookup"].toObject()["count"].toInt(), 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testStatisticsChromeTrace()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/trace.json";
+
+    CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithStatistics(path)
+            .getCommandLineInterface();
+
+    QFile file( path );
+    QVERIFY( file.open( QIODevice::ReadOnly ) );
+
+    QJsonArray events = QJsonDocument::fromJson( file.readAll() ).object()["traceEvents"].toArray();
+    QStringList names;
+    foreach( QJsonValue event, events )
+    {
+        QCOMPARE( event.toObject()["ph"].toString(), QStringLiteral("X") );
+        names.append( event.toObject()["name"].toString() );
+    }
+    QCOMPARE( names, QStringList({"registration", "tokenization", "configuration", "callbacks"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaConstructionAllocationBudget()
+{
+    AllocationTracker tracker;
+    CommandLineInterfaceBuilder builder("My Cool App", QStringList());
+    addRepresentativeSchema( builder );
+    quint64 allocations = tracker.allocations();
+
+    QVERIFY2( allocations <= 20 * 40 + 200,
+              qPrintable( QString("Building 20 arguments made %1 allocations").arg( allocations ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testTokenizationAllocationBudget()
+{
+    const int tokens = 1000;
+    QStringList arguments;
+    for ( int i = 0; i < tokens; ++i )
+    {
+        arguments << QStringLiteral("--server=1.2.3.4");
+    }
+    CommandLineInterfaceBuilder builder("My Cool App", arguments);
+    addRepresentativeSchema( builder );
+
+    AllocationTracker tracker;
+    CommandLineInterface cli = builder.getCommandLineInterface();
+    quint64 allocations = tracker.allocations();
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+    QVERIFY2( allocations <= tokens * 6 + 200,
+              qPrintable( QString("Parsing %1 options made %2 allocations").arg( tokens ).arg( allocations ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPositionalTokenizationAllocationBudget()
+{
+    const int tokens = 10000;
+    QStringList arguments;
+    for ( int i = 0; i < tokens; ++i )
+    {
+        arguments << QStringLiteral("file.txt");
+    }
+    CommandLineInterfaceBuilder builder("My Cool App", arguments);
+    builder.WithPositionalList("files", "Files to process.");
+
+    AllocationTracker tracker;
+    CommandLineInterface cli = builder.getCommandLineInterface();
+    quint64 allocations = tracker.allocations();
+
+    QCOMPARE( cli.positionalArguments().count(), tokens );
+    QVERIFY2( allocations <= 100,
+              qPrintable( QString("Parsing %1 positional arguments made %2 allocations").arg( tokens ).arg( allocations ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLookupAllocationBudget()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"--server=1.2.3.4"});
+    CommandLineInterface cli = addRepresentativeSchema( builder ).getCommandLineInterface();
+    const QString key = QStringLiteral("SerVer");
+    int found = 0;
+
+    AllocationTracker tracker;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        found += cli[key].isValid() ? 1 : 0;
+    }
+    quint64 allocations = tracker.allocations();
+
+    QCOMPARE( found, 1000 );
+    QVERIFY2( allocations <= 10,
+              qPrintable( QString("1000 lookups made %1 allocations").arg( allocations ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpRenderingAllocationBudget()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", QStringList());
+    CommandLineInterface cli = addRepresentativeSchema( builder ).getCommandLineInterface();
+
+    AllocationTracker tracker;
+    QString help = cli.helpMessage();
+    quint64 allocations = tracker.allocations();
+
+    QVERIFY( help.contains( "--server" ) );
+    QVERIFY2( allocations <= 20 * 30 + 200,
+              qPrintable( QString("Rendering help for 20 arguments made %1 allocations").arg( allocations ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMegabyteTokenParsesInLinearTime()
+{
+    // The limits are far above what a linear parse needs but far below what a quadratic one would take.
+    const qint64 timeLimit = 5000;
+    QString value( 1024 * 1024, QChar('a') );
+
+    QElapsedTimer timer;
+    timer.start();
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server=" + value})
+            .WithValue("server", "Server to connect to.");
+    qint64 elapsed = timer.elapsed();
+
+    QCOMPARE( cli["server"].toString().length(), value.length() );
+    QVERIFY2( elapsed < timeLimit, qPrintable( QString("A megabyte token took %1 ms").arg( elapsed ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMegabyteNameParsesInLinearTime()
+{
+    const qint64 timeLimit = 5000;
+    QString name( 1024 * 1024, QChar('a') );
+
+    QElapsedTimer timer;
+    timer.start();
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--" + name, "1.2.3.4", "--server", "5.6.7.8"})
+            .WithValue("server", "Server to connect to.");
+    qint64 elapsed = timer.elapsed();
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("5.6.7.8") );
+    QVERIFY2( elapsed < timeLimit, qPrintable( QString("A megabyte argument name took %1 ms").arg( elapsed ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMillionSeperatorsParseInLinearTime()
+{
+    const qint64 timeLimit = 5000;
+    QString seperators;
+    seperators.reserve( 1000000 );
+    for ( int i = 0; i < 500000; ++i )
+    {
+        seperators += QStringLiteral(":=");
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server" + seperators, "--user", seperators})
+            .WithValue("server", "Server to connect to.")
+            .WithValue("user", "User to run as.");
+    qint64 elapsed = timer.elapsed();
+
+    QCOMPARE( cli["server"].toString(), seperators.mid(1) );
+    QCOMPARE( cli["user"].toString(), seperators );
+    QVERIFY2( elapsed < timeLimit, qPrintable( QString("A million seperators took %1 ms").arg( elapsed ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMillionTinyTokensParseInLinearTime()
+{
+    const qint64 timeLimit = 10000;
+    QStringList arguments;
+    arguments.reserve( 1000000 );
+    for ( int i = 0; i < 500000; ++i )
+    {
+        arguments << QStringLiteral("-d") << QStringLiteral("f");
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", arguments)
+            .WithFlag("debug", "Enables debug mode.")
+            .WithPositionalList("files", "Files to process.");
+    qint64 elapsed = timer.elapsed();
+
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli.positionalArguments().count(), 500000 );
+    QVERIFY2( elapsed < timeLimit, qPrintable( QString("A million tokens took %1 ms").arg( elapsed ) ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPlaceholdersInInputAreNotExpanded()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server%2", "1.2.3.4", "--user", "%1%2"})
+            .WithValue("server", "Server to connect to.")
+            .WithValue("user", "User to run as.");
+
+    QVERIFY( !cli["server"].toString().contains( "1.2.3.4" ) );
+    QCOMPARE( cli["user"].toString(), QStringLiteral("%1%2") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingDefersProcessing()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server", "1.2.3.4"})
+            .WithValue("server", "Server to connect to.")
+            .WithLazyParsing();
+
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 0 );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingProcessesOnlyOnce()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server", "1.2.3.4"})
+            .WithValue("server", "Server to connect to.")
+            .WithLazyParsing();
+
+    QCOMPARE( cli["server"].toString(), QStringLiteral("1.2.3.4") );
+    cli.setValue( "server", "5.6.7.8" );
+    QCOMPARE( cli["server"].toString(), QStringLiteral("5.6.7.8") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingSharedByCopies()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server", "1.2.3.4", "a.txt"})
+            .WithValue("server", "Server to connect to.")
+            .WithPositional("file", "File to process.")
+            .WithLazyParsing();
+    CommandLineInterface copy = cli;
+
+    cli.setValue( "server", "5.6.7.8" );
+    QCOMPARE( copy.m_processedState->processed.loadAcquire(), 1 );
+    QCOMPARE( copy["server"].toString(), QStringLiteral("5.6.7.8") );
+    QCOMPARE( copy["file"].toString(), QStringLiteral("a.txt") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingOfPositionalArguments()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"-d", "a.txt", "b.txt"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithPositionalList("files", "Files to process.")
+            .WithLazyParsing();
+
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 0 );
+    QCOMPARE( cli.positional("files").toStringList(), QStringList({"a.txt", "b.txt"}) );
+    QCOMPARE( cli["debug"].toBool(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingRunsActionsStraightAway()
+{
+    bool restarted( false );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--restart"})
+            .WithAction("restart", "Restarts the service.", [&restarted](QVariant) { restarted = true; })
+            .WithLazyParsing();
+
+    QCOMPARE( restarted, true );
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingWritesBoundValuesStraightAway()
+{
+    int port = 80;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--port", "8080"})
+            .WithValue("port", "Port to connect to.", &port)
+            .WithLazyParsing();
+
+    QCOMPARE( port, 8080 );
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testLazyParsingChecksRulesStraightAway()
+{
+    QVERIFY_EXCEPTION_THROWN(CommandLineInterfaceBuilder("My Cool App", {"--server", "1.2.3.4"})
+            .WithValue("server", "Server to connect to.")
+            .WithValue("input", "The input file.")
+            .WithRequired("input")
+            .WithLazyParsing()
+            .getCommandLineInterface(), ConstraintViolationException);
+
+    QVERIFY_EXCEPTION_THROWN(CommandLineInterfaceBuilder("My Cool App", {"--port", "0"})
+            .WithValue("port", "The port to listen on.")
+            .WithRange("port", 1, 65535)
+            .WithLazyParsing()
+            .getCommandLineInterface(), ValidationException);
+
+    QVERIFY_EXCEPTION_THROWN(CommandLineInterfaceBuilder("My Cool App", {"--log-level", "loud"})
+            .WithChoice("log-level", {"debug", "info", "warn"}, "Sets how much is logged.")
+            .WithLazyParsing()
+            .getCommandLineInterface(), InvalidChoiceException);
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--server", "1.2.3.4"})
+            .WithValue("server", "Server to connect to.")
+            .WithValue("port", "The port to listen on.")
+            .WithRange("port", 1, 65535)
+            .WithLazyParsing();
+
+    QCOMPARE( cli.m_processedState->processed.loadAcquire(), 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testVersionOnlyRequestSkipsRegistration()
+{
+    // Building the interface would print the version and exit so only the builder is inspected.
+    CommandLineInterfaceBuilder builder("My Cool App", {"--version"});
+    builder.WithVersion("1.2.3.4")
+           .WithFlag("debug", "Enables debug mode.")
+           .WithValue("server", "Server to connect to.")
+           .WithPositional("source", "File to copy.")
+           .WithPriority("server", 10);
+
+    QVERIFY( builder.m_cli->m_arguments.contains("version") );
+    QVERIFY( !builder.m_cli->m_arguments.contains("debug") );
+    QVERIFY( !builder.m_cli->m_arguments.contains("server") );
+    QVERIFY( builder.m_cli->m_positionalArguments.isEmpty() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testVersionShortNameOnlyRequestSkipsRegistration()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"-v"});
+    builder.WithVersion("1.2.3.4")
+           .WithFlag("debug", "Enables debug mode.");
+
+    QVERIFY( !builder.m_cli->m_arguments.contains("debug") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testVersionWithOtherInputsRegistersEverything()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"--version", "--debug"});
+    builder.WithVersion("1.2.3.4")
+           .WithFlag("debug", "Enables debug mode.");
+
+    QVERIFY( builder.m_cli->m_arguments.contains("debug") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCustomVersionActionRegistersEverything()
+{
+    bool versionRequested( false );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--version"})
+            .WithVersion("1.2.3.4", [&versionRequested](QVariant) { versionRequested = true; })
+            .WithFlag("debug", "Enables debug mode.");
+
+    QCOMPARE( versionRequested, true );
+    QVERIFY( cli.m_arguments.contains("debug") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpMessageIsRenderedOnce()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithFlag("debug", "Enables debug mode.");
+
+    QString help = cli.helpMessage();
+    QCOMPARE( cli.m_renderedHelp, help );
+    QCOMPARE( cli.helpMessage(), help );
+
+    cli.addArgument( new Argument( "force", "Forces a refresh.", ArgumentType::Boolean, nullptr ) );
+    QVERIFY( cli.helpMessage().contains( "--force" ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheIsUsedOnTheNextBuild()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+    int registrations = 0;
+    auto registration = [&registrations](CommandLineInterfaceBuilder& builder) {
+        ++registrations;
+        builder.WithFlag("debug", "Enables debug mode.")
+               .WithValue("server", "localhost", "Server to connect to.")
+               .WithPositional("source", "File to copy.");
+    };
+
+    CommandLineInterface first = CommandLineInterfaceBuilder("My Cool App", {"-d"})
+            .WithSchemaCache(path, "1", registration);
+    QCOMPARE( registrations, 1 );
+    QVERIFY( QFile::exists( path ) );
+    QCOMPARE( first["debug"].toBool(), true );
+
+    CommandLineInterface second = CommandLineInterfaceBuilder("My Cool App", {"-d", "--server", "1.2.3.4", "a.txt"})
+            .WithSchemaCache(path, "1", registration);
+    QCOMPARE( registrations, 1 );
+    QCOMPARE( second["debug"].toBool(), true );
+    QCOMPARE( second["server"].toString(), QStringLiteral("1.2.3.4") );
+    QCOMPARE( second["source"].toString(), QStringLiteral("a.txt") );
+    QCOMPARE( second.helpMessage(), first.helpMessage() );
+
+    CommandLineInterface third = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithSchemaCache(path, "1", registration);
+    QCOMPARE( third["server"].toString(), QStringLiteral("localhost") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheIsRebuiltWhenManifestChanges()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+    int registrations = 0;
+    auto registration = [&registrations](CommandLineInterfaceBuilder& builder) {
+        ++registrations;
+        builder.WithFlag("debug", "Enables debug mode.");
+    };
+
+    CommandLineInterfaceBuilder("My Cool App", QStringList()).WithSchemaCache(path, "1", registration).getCommandLineInterface();
+    CommandLineInterfaceBuilder("My Cool App", QStringList()).WithSchemaCache(path, "2", registration).getCommandLineInterface();
+    CommandLineInterfaceBuilder("My Cool App", QStringList()).WithSchemaCache(path, "2", registration).getCommandLineInterface();
+    QCOMPARE( registrations, 2 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheNotWrittenForCallbacks()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+
+    CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithSchemaCache(path, "1", [](CommandLineInterfaceBuilder& builder) {
+                builder.WithFlag("debug", "Enables debug mode.", [](QVariant) {});
+            })
+            .getCommandLineInterface();
+
+    QVERIFY( !QFile::exists( path ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheNotWrittenForRules()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+
+    CommandLineInterfaceBuilder("My Cool App", {"--input", "in.txt"})
+            .WithSchemaCache(path, "1", [](CommandLineInterfaceBuilder& builder) {
+                builder.WithValue("input", "The file to read.")
+                       .WithRequired("input");
+            })
+            .getCommandLineInterface();
+
+    QVERIFY( !QFile::exists( path ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheCollisionFallsBackToRegistration()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+    auto registration = [](CommandLineInterfaceBuilder& builder) {
+        builder.WithFlag("debug", "Enables debug mode.");
+    };
+
+    CommandLineInterfaceBuilder("My Cool App", QStringList()).WithSchemaCache(path, "1", registration).getCommandLineInterface();
+
+    CommandLineInterfaceBuilder builder("My Cool App", QStringList());
+    builder.WithFlag("debug", "Enables debug mode.");
+    QVERIFY_EXCEPTION_THROWN( builder.WithSchemaCache(path, "1", registration), ArgumentRedefinitionException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSchemaCacheNotWrittenForAliasOfExistingArgument()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/schema.cache";
+    int registrations = 0;
+    auto registration = [&registrations](CommandLineInterfaceBuilder& builder) {
+        ++registrations;
+        builder.WithValue("port", "8080", "Port to connect to.")
+               .WithAlias("host", "server");
+    };
+
+    CommandLineInterface first = CommandLineInterfaceBuilder("My Cool App", {"--host", "1.2.3.4"})
+            .WithValue("server", "localhost", "Server to connect to.")
+            .WithSchemaCache(path, "1", registration);
+    QCOMPARE( registrations, 1 );
+    QVERIFY( !QFile::exists( path ) );
+    QCOMPARE( first["server"].toString(), QStringLiteral("1.2.3.4") );
+
+    CommandLineInterface second = CommandLineInterfaceBuilder("My Cool App", {"--host", "1.2.3.4"})
+            .WithValue("server", "localhost", "Server to connect to.")
+            .WithSchemaCache(path, "1", registration);
+    QCOMPARE( registrations, 2 );
+    QCOMPARE( second["server"].toString(), QStringLiteral("1.2.3.4") );
+    QCOMPARE( second["port"].toString(), QStringLiteral("8080") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDamagedSchemaCacheIsIgnored()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/schema.cache", "TRNS not really a cache" );
+    int registrations = 0;
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"-d"})
+            .WithSchemaCache(path, "1", [&registrations](CommandLineInterfaceBuilder& builder) {
+                ++registrations;
+                builder.WithFlag("debug", "Enables debug mode.");
+            });
+
+    QCOMPARE( registrations, 1 );
+    QCOMPARE( cli["debug"].toBool(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNamespaceLoadedForInputUnderIt()
+{
+    int loads = 0;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--auth.ldap.url", "ldap://example.com"})
+            .WithNamespace("auth", [&loads](CommandLineInterfaceBuilder& builder) {
+                ++loads;
+                builder.WithValue("auth.ldap.url", "The LDAP server.");
+            });
+
+    QCOMPARE( loads, 1 );
+    QCOMPARE( cli["auth.ldap.url"].toString(), QStringLiteral("ldap://example.com") );
+    QCOMPARE( loads, 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNamespaceNotLoadedWhenUnused()
+{
+    int loads = 0;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug", "--cache.size=10"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithNamespace("auth", [&loads](CommandLineInterfaceBuilder& builder) {
+                ++loads;
+                builder.WithValue("auth.ldap.url", "The LDAP server.");
+            });
+
+    QCOMPARE( cli["debug"].toBool(), true );
+    QCOMPARE( cli["cache.size"], QVariant() );
+    QCOMPARE( loads, 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNamespaceLoadedWhenValueRead()
+{
+    int loads = 0;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithNamespace("auth", [&loads](CommandLineInterfaceBuilder& builder) {
+                ++loads;
+                builder.WithValue("auth.ldap.url", "ldap://localhost", "The LDAP server.");
+            });
+
+    QCOMPARE( loads, 0 );
+    QCOMPARE( cli["auth.ldap.url"].toString(), QStringLiteral("ldap://localhost") );
+    QCOMPARE( cli["Auth.LDAP.url"].toString(), QStringLiteral("ldap://localhost") );
+    QCOMPARE( loads, 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNestedNamespacesLoadOuterFirst()
+{
+    QStringList loaded;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--auth.ldap.url=ldap://example.com"})
+            .WithNamespace("auth.ldap", [&loaded](CommandLineInterfaceBuilder& builder) {
+                loaded << "auth.ldap";
+                builder.WithValue("auth.ldap.url", "The LDAP server.");
+            })
+            .WithNamespace("auth", [&loaded](CommandLineInterfaceBuilder& builder) {
+                loaded << "auth";
+                builder.WithFlag("auth.required", "Require a login.");
+            });
+
+    QCOMPARE( loaded, QStringList({"auth", "auth.ldap"}) );
+    QCOMPARE( cli["auth.ldap.url"].toString(), QStringLiteral("ldap://example.com") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpLoadsEveryNamespace()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithNamespace("auth", [](CommandLineInterfaceBuilder& builder) {
+                builder.WithValue("auth.ldap.url", "The LDAP server.");
+            });
+
+    QVERIFY( cli.helpMessage().contains( "  --auth.ldap.url\tThe LDAP server.\n" ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDottedNamesHaveNoShortName()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--cache.size", "10"})
+            .WithValue("cache.size", "The cache size.")
+            .WithValue("cache.path", "The cache location.");
+
+    QCOMPARE( cli["cache.size"].toString(), QStringLiteral("10") );
+    QCOMPARE( cli["c"], QVariant() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSubtreeContainsOnlyArgumentsUnderPath()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithValue("db.primary.host", "localhost", "The primary database host.")
+            .WithValue("db.primary.port", "5432", "The primary database port.")
+            .WithValue("db.primaryish", "no", "Not under db.primary.")
+            .WithValue("db.replica.host", "replica", "The replica database host.")
+            .WithValue("dbx.primary.host", "other", "Not under db.");
+
+    ArgumentSubtree primary = cli.subtree("db.primary");
+    QCOMPARE( primary.path(), QStringLiteral("db.primary") );
+    QCOMPARE( primary.count(), 2 );
+    QCOMPARE( primary.names(), QStringList({"host", "port"}) );
+
+    QCOMPARE( cli.subtree("db").count(), 4 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSubtreeLooksUpRelativeNames()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--db.primary.port", "6543"})
+            .WithValue("db.primary.host", "localhost", "The primary database host.")
+            .WithValue("db.primary.port", "5432", "The primary database port.");
+
+    ArgumentSubtree primary = cli.subtree("DB.Primary");
+    QCOMPARE( primary.contains("host"), true );
+    QCOMPARE( primary.contains("user"), false );
+    QCOMPARE( primary["Host"].toString(), QStringLiteral("localhost") );
+    QCOMPARE( primary.value("port").toInt(), 6543 );
+    QCOMPARE( primary["user"], QVariant() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testNestedSubtree()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithValue("db.primary.host", "localhost", "The primary database host.")
+            .WithValue("db.replica.host", "replica", "The replica database host.");
+
+    ArgumentSubtree replica = cli.subtree("db").subtree("replica");
+    QCOMPARE( replica.path(), QStringLiteral("db.replica") );
+    QCOMPARE( replica.count(), 1 );
+    QCOMPARE( replica["host"].toString(), QStringLiteral("replica") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSubtreeOfUnknownPathIsEmpty()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithValue("db.primary.host", "localhost", "The primary database host.");
+
+    QCOMPARE( cli.subtree("cache").isEmpty(), true );
+    QCOMPARE( cli.subtree("").isEmpty(), true );
+    QCOMPARE( ArgumentSubtree().isEmpty(), true );
+    QCOMPARE( ArgumentSubtree()["host"], QVariant() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSubtreeLoadsNamespacesUnderPath()
+{
+    QStringList loaded;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithNamespace("db.primary", [&loaded](CommandLineInterfaceBuilder& builder) {
+                loaded << "db.primary";
+                builder.WithValue("db.primary.host", "localhost", "The primary database host.");
+            })
+            .WithNamespace("auth", [&loaded](CommandLineInterfaceBuilder& builder) {
+                loaded << "auth";
+                builder.WithValue("auth.ldap.url", "The LDAP server.");
+            });
+
+    ArgumentSubtree db = cli.subtree("db");
+    QCOMPARE( loaded, QStringList({"db.primary"}) );
+    QCOMPARE( db["primary.host"].toString(), QStringLiteral("localhost") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSubtreeIteratesInNameOrder()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--db.port=6543"})
+            .WithValue("db.user", "admin", "The database user.")
+            .WithValue("db.host", "localhost", "The database host.")
+            .WithValue("db.port", "5432", "The database port.");
+
+    QStringList keys;
+    QStringList values;
+    ArgumentSubtree db = cli.subtree("db");
+    for ( ArgumentSubtree::const_iterator it = db.begin(); it != db.end(); ++it )
+    {
+        keys << it.key();
+        values << it.value().toString();
+    }
+
+    QCOMPARE( keys, QStringList({"db.host", "db.port", "db.user"}) );
+    QCOMPARE( values, QStringList({"localhost", "6543", "admin"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletesOptionNames()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"--__complete", "--d"});
+    builder.WithFlag("debug", "Enables debug mode.")
+           .WithValue("deploy.target", "Where to deploy to.")
+           .WithValue("address", "The address to connect to.")
+           .WithStatistics();
+
+    QCOMPARE( builder.m_cli->completions( builder.m_cli->m_completionPartial ), QStringList({"--debug", "--deploy.target"}) );
+    QCOMPARE( builder.m_cli->completions( "-a" ), QStringList({"-address"}) );
+    QCOMPARE( builder.m_cli->completions( "--taranis" ), QStringList() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletesValuesFromProvider()
+{
+    QString asked;
+    CommandLineInterfaceBuilder builder("My Cool App", {"--__complete", "--profile", "st"});
+    builder.WithValue("profile", "The profile to use.")
+           .WithCompletion("profile", [&asked](QString partial) {
+                asked = partial;
+                return QStringList({"staging", "stable", "production"});
+            });
+
+    QCOMPARE( builder.m_cli->completions( builder.m_cli->m_completionPartial ), QStringList({"staging", "stable"}) );
+    QCOMPARE( asked, QStringLiteral("st") );
+
+    builder.m_cli->m_inputArguments.clear();
+    QCOMPARE( builder.m_cli->completions( "--profile=p" ), QStringList({"--profile=production"}) );
+    QCOMPARE( asked, QStringLiteral("p") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletesCommands()
+{
+    CommandLineInterfaceBuilder top("My Cool App", {"--__complete", "b"});
+    top.WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder&) {})
+       .WithCommand("bundle", "Bundles the project.", [](CommandLineInterfaceBuilder&) {})
+       .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder&) {});
+
+    QCOMPARE( top.m_cli->completions( top.m_cli->m_completionPartial ), QStringList({"build", "bundle"}) );
+
+    CommandLineInterfaceBuilder nested("My Cool App", {"--__complete", "build", "--j"});
+    nested.WithCommand("build", "Builds the project.", [](CommandLineInterfaceBuilder& build) {
+                build.WithValue("jobs", "1", "Number of parallel jobs.");
+            })
+          .WithCommand("deploy", "Deploys the project.", [](CommandLineInterfaceBuilder& deploy) {
+                deploy.WithValue("jump-host", "The host to deploy through.");
+            });
+
+    QCOMPARE( nested.m_cli->completions( nested.m_cli->m_completionPartial ), QStringList({"--jobs"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletionSkipsProcessing()
+{
+    int calls = 0;
+    CommandLineInterfaceBuilder builder("My Cool App", {"--__complete", "--version", "--de"});
+    builder.WithVersion("1.0")
+           .WithFlag("debug", "Enables debug mode.", [&calls](QVariant) { ++calls; })
+           .WithEnvironment("COOLAPP_")
+           .WithConfigFile("coolapp.ini");
+
+    QCOMPARE( builder.m_cli->completions( builder.m_cli->m_completionPartial ), QStringList({"--debug"}) );
+    QCOMPARE( builder.m_cli->m_environmentPrefix, QString() );
+    QCOMPARE( builder.m_cli->m_configurationFiles, QStringList() );
+    QCOMPARE( calls, 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletionLoadsOnlyMatchingNamespaces()
+{
+    QStringList loaded;
+    CommandLineInterfaceBuilder builder("My Cool App", {"--__complete", "--auth.l"});
+    builder.WithNamespace("auth", [&loaded](CommandLineInterfaceBuilder& auth) {
+                loaded << "auth";
+                auth.WithValue("auth.ldap.url", "The LDAP server.")
+                    .WithFlag("auth.required", "Require a login.");
+            })
+           .WithNamespace("db", [&loaded](CommandLineInterfaceBuilder& db) {
+                loaded << "db";
+                db.WithValue("db.host", "The database host.");
+            });
+
+    QCOMPARE( builder.m_cli->completions( builder.m_cli->m_completionPartial ), QStringList({"--auth.ldap.url"}) );
+    QCOMPARE( loaded, QStringList({"auth"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCompletionScripts()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList());
+
+    QString bash = cli.completionScript( "bash", "cool-app" );
+    QVERIFY( bash.contains( "complete -o default -F _cool_app_complete cool-app\n" ) );
+    QVERIFY( bash.contains( "--__complete" ) );
+    QVERIFY( !bash.contains( "COMP_WORDBREAKS=" ) );
+
+    QVERIFY( cli.completionScript( "zsh", "cool-app" ).contains( "compdef _cool_app_complete cool-app\n" ) );
+    QVERIFY( cli.completionScript( "fish", "cool-app" ).contains( "complete -c cool-app -a '(__cool_app_complete)'\n" ) );
+    QCOMPARE( cli.completionScript( "powershell", "cool-app" ), QString() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testChoiceStoresOrdinal()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--log-level", "WARN"})
+            .WithChoice("log-level", {"debug", "info", "warn"}, "Sets how much is logged.");
+
+    QCOMPARE( cli["log-level"], QVariant( 2 ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testChoiceDefault()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithChoice("log-level", {"debug", "info", "warn"}, "info", "Sets how much is logged.")
+            .WithChoice("mode", {"fast", "safe"}, "Sets the mode.");
+
+    QCOMPARE( cli["log-level"], QVariant( 1 ) );
+    QCOMPARE( cli["mode"], QVariant() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInvalidChoiceThrows()
+{
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--log-level=verbose"})
+            .WithChoice("log-level", {"debug", "info", "warn"}, "Sets how much is logged."), InvalidChoiceException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testChoiceTableFindsEveryChoice()
+{
+    QStringList choices;
+    for ( int i = 0; i < 100; ++i )
+    {
+        choices << QString("Choice%1").arg(i);
+    }
+    ChoiceTable table( choices );
+
+    for ( int i = 0; i < choices.count(); ++i )
+    {
+        QCOMPARE( table.ordinal( choices.at(i) ), i );
+        QCOMPARE( table.ordinal( choices.at(i).toUpper() ), i );
+    }
+    QCOMPARE( table.ordinal( "Choice100" ), -1 );
+    QCOMPARE( table.ordinal( "" ), -1 );
+    QCOMPARE( ChoiceTable().ordinal( "Choice0" ), -1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpListsChoices()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", QStringList())
+            .WithChoice("log-level", {"debug", "info", "warn"}, "Sets how much is logged.");
+
+    QVERIFY( cli.helpMessage().contains( "  -l, --log-level\tSets how much is logged. {debug|info|warn}\n" ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testMissingRequiredArgumentThrows()
+{
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--debug"})
+            .WithFlag("debug", "Enables debug mode.")
+            .WithValue("input", "The file to read.")
+            .WithRequired("input"), ConstraintViolationException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConstraintsSatisfied()
+{
+    QVERIFY_NO_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--input", "a.txt", "--json", "--output=b.json"})
+            .WithValue("input", "The file to read.")
+            .WithValue("output", "The file to write.")
+            .WithFlag("json", "Write JSON.")
+            .WithFlag("xml", "Write XML.")
+            .WithRequired("input")
+            .WithExclusive({"json", "xml"})
+            .WithAtLeastOne({"json", "xml"})
+            .WithRequires("json", "output") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testEveryViolationIsReported()
+{
+    QStringList violations;
+    try
+    {
+        CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--json", "--xml"})
+                .WithValue("input", "The file to read.")
+                .WithValue("output", "The file to write.")
+                .WithFlag("json", "Write JSON.")
+                .WithFlag("xml", "Write XML.")
+                .WithFlag("yaml", "Write YAML.")
+                .WithFlag("csv", "Write CSV.")
+                .WithRequired("input")
+                .WithExclusive({"json", "xml", "yaml"})
+                .WithAtLeastOne({"yaml", "csv"})
+                .WithRequires("json", "output");
+    }
+    catch ( const ConstraintViolationException& e )
+    {
+        violations = e.violations();
+    }
+
+    QCOMPARE( violations, QStringList({
+                  "The argument {input} is required.",
+                  "Only one of {json, xml} can be given.",
+                  "At least one of {yaml, csv} must be given.",
+                  "The argument {json} requires {output}." }) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testViolationsStopCallbacks()
+{
+    int calls = 0;
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--json", "--xml"})
+            .WithFlag("json", "Write JSON.", [&calls](QVariant) { ++calls; })
+            .WithFlag("xml", "Write XML.", [&calls](QVariant) { ++calls; })
+            .WithExclusive({"json", "xml"}), ConstraintViolationException );
+
+    QCOMPARE( calls, 0 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHelpSkipsConstraints()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"--help"});
+    builder.WithValue("input", "The file to read.")
+           .WithRequired("input");
+
+    QSet<Argument*> provided;
+    provided.insert( builder.m_cli->m_arguments.value("help") );
+    QVERIFY_NO_EXCEPTION_THROWN( builder.m_cli->checkConstraints( provided ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testRejectedCommandLineLeavesStoreUsable()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {"--port", "0"});
+    builder.WithValue("port", "80", "The port to listen on.")
+           .WithRange("port", 1, 65535);
+
+    QVERIFY_EXCEPTION_THROWN( builder.m_cli->process(), ValidationException );
+
+    builder.m_cli->setValue( "port", "8080" );
+    QCOMPARE( (*builder.m_cli)["port"].toString(), QStringLiteral("8080") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testRejectedCommandLineLeavesBoundStorageAlone()
+{
+    bool json = false;
+    QString output;
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--json", "--output", "out.json"})
+            .WithFlag("json", "Write JSON.", &json)
+            .WithValue("output", "The file to write.", &output)
+            .WithValue("input", "The file to read.")
+            .WithRequired("input"), ConstraintViolationException );
+
+    QCOMPARE( json, false );
+    QVERIFY( output.isEmpty() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testConfigurationValueSatisfiesRequired()
+{
+    qputenv( "TARANISTEST_PORT", "8080" );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("port", "The port to listen on.")
+            .WithRequired("port")
+            .WithEnvironment("TARANISTEST");
+    qunsetenv( "TARANISTEST_PORT" );
+
+    QCOMPARE( cli["port"].toString(), QStringLiteral("8080") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testRangeValidator()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--port", "8080"})
+            .WithValue("port", "The port to listen on.")
+            .WithRange("port", 1, 65535);
+    QCOMPARE( cli["port"].toInt(), 8080 );
+
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--port", "0"})
+            .WithValue("port", "The port to listen on.")
+            .WithRange("port", 1, 65535), ValidationException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPatternMatchesWholeValue()
+{
+    QStringList failures;
+    try
+    {
+        CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--user=bob", "--group=staff1"})
+                .WithValue("user", "The user to run as.")
+                .WithValue("group", "The group to run as.")
+                .WithPattern("user", "[a-z]+")
+                .WithPattern("group", "[a-z]+");
+    }
+    catch ( const ValidationException& e )
+    {
+        failures = e.failures();
+    }
+    QCOMPARE( failures, QStringList({"The value {staff1} of {group} does not match the expected format."}) );
+
+    CommandLineInterfaceBuilder builder("My Cool App", QStringList());
+    builder.WithValue("user", "The user to run as.")
+           .WithValue("group", "The group to run as.")
+           .WithPattern("user", "[a-z]+")
+           .WithPattern("group", "[a-z]+");
+    QCOMPARE( builder.m_cli->m_patterns.count(), 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testHostPortValidator()
+{
+    ArgumentValidator validator = ArgumentValidator::hostPort();
+
+    QCOMPARE( validator.validate( "server", "example.com:8080" ), QString() );
+    QCOMPARE( validator.validate( "server", "10.0.0.1:22" ), QString() );
+    QCOMPARE( validator.validate( "server", "[::1]:443" ), QString() );
+    QVERIFY( !validator.validate( "server", "example.com" ).isEmpty() );
+    QVERIFY( !validator.validate( "server", "example.com:0" ).isEmpty() );
+    QVERIFY( !validator.validate( "server", "example.com:70000" ).isEmpty() );
+    QVERIFY( !validator.validate( "server", ":8080" ).isEmpty() );
+    QVERIFY( !validator.validate( "server", "bad_host:8080" ).isEmpty() );
+    QVERIFY( !validator.validate( "server", "[::1:443" ).isEmpty() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testFileChecksAreBatchedAndAggregated()
+{
+    QTemporaryDir directory;
+    QVERIFY( directory.isValid() );
+
+    const int count = 500;
+    QStringList inputs;
+    for ( int i = 0; i < count; ++i )
+    {
+        QString path = directory.path() + QString("/file%1.txt").arg(i);
+        if ( ( i % 100 ) != 7 )
+        {
+            QFile file( path );
+            QVERIFY( file.open( QIODevice::WriteOnly ) );
+        }
+        inputs << QString("--file.%1=%2").arg(i).arg(path);
+    }
+
+    QStringList failures;
+    try
+    {
+        CommandLineInterfaceBuilder builder("My Cool App", inputs);
+        for ( int i = 0; i < count; ++i )
+        {
+            QString name = QString("file.%1").arg(i);
+            builder.WithValue( name, "A file to deploy." ).WithExistingFile( name );
+        }
+        CommandLineInterface cli = builder;
+    }
+    catch ( const ValidationException& e )
+    {
+        failures = e.failures();
+    }
+
+    QCOMPARE( failures.count(), 5 );
+    for ( int i = 0; i < failures.count(); ++i )
+    {
+        QVERIFY( failures.at(i).contains( QString("{file.%1}").arg( i * 100 + 7 ) ) );
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testBoundValueValidatedBeforeWrite()
+{
+    int port = 80;
+    QVERIFY_EXCEPTION_THROWN( CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--port", "99999"})
+            .WithValue("port", "The port to listen on.", &port)
+            .WithRange("port", 1, 65535), ValidationException );
+
+    QCOMPARE( port, 80 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadInlineValue()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "allow all"})
+            .WithPayload("policy", "The policy document.");
+
+    Payload payload = cli["policy"].value<Payload>();
+    QCOMPARE( payload.source(), Payload::Inline );
+    QCOMPARE( payload.data(), QByteArray("allow all") );
+    QCOMPARE( payload.device()->readAll(), QByteArray("allow all") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadEscapedAtSign()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "@@admin"})
+            .WithPayload("policy", "The policy document.");
+
+    Payload payload = cli["policy"].value<Payload>();
+    QCOMPARE( payload.source(), Payload::Inline );
+    QCOMPARE( payload.data(), QByteArray("@admin") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadFromFile()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/policy.txt", "deny everyone\nallow admin\n" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "@" + path})
+            .WithPayload("policy", "The policy document.");
+
+    Payload payload = cli["policy"].value<Payload>();
+    QCOMPARE( payload.source(), Payload::File );
+    QCOMPARE( payload.path(), path );
+    QCOMPARE( payload.data(), QByteArray("deny everyone\nallow admin\n") );
+    QVERIFY( payload.errorString().isEmpty() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadFromMissingFile()
+{
+    QTemporaryDir dir;
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "@" + dir.path() + "/missing.txt"})
+            .WithPayload("policy", "The policy document.");
+
+    Payload payload = cli["policy"].value<Payload>();
+    QVERIFY( payload.data().isEmpty() );
+    QVERIFY( !payload.errorString().isEmpty() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadTooLargeForData()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/huge.bin";
+    qint64 size = qint64( std::numeric_limits<int>::max() ) + 1;
+    {
+        // Sparse on the usual file systems so nothing close to 2 GiB is written.
+        QFile file( path );
+        if ( !file.open( QIODevice::WriteOnly ) || !file.resize( size ) )
+        {
+            QSKIP("Can't make a 2 GiB file here");
+        }
+    }
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "@" + path})
+            .WithPayload("policy", "The policy document.");
+
+    Payload payload = cli["policy"].value<Payload>();
+    QVERIFY( payload.data().isEmpty() );
+    QVERIFY( !payload.errorString().isEmpty() );
+
+    QIODevice* device = payload.device();
+    QVERIFY( device != nullptr );
+    QCOMPARE( device->size(), size );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadFromStandardInput()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "-"})
+            .WithPayload("policy", "The policy document.");
+
+    QCOMPARE( cli["policy"].value<Payload>().source(), Payload::StandardInput );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadIsNotReadUntilAccessed()
+{
+    QTemporaryDir dir;
+    QString path = writeFile( dir.path() + "/policy.txt", "old" );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--policy", "@" + path})
+            .WithPayload("policy", "The policy document.");
+
+    writeFile( path, "new" );
+
+    QCOMPARE( cli["policy"].value<Payload>().data(), QByteArray("new") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPayloadUnchangedByReload()
+{
+    QTemporaryDir dir;
+    QString policy = writeFile( dir.path() + "/policy.txt", "deny everyone\n" );
+    QString path = writeFile( dir.path() + "/app.ini", ( "policy=@" + policy + "\nmode=fast\n" ).toUtf8() );
+
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithPayload("policy", "The policy document.")
+            .WithValue("mode", "The mode.")
+            .WithConfigFile(path)
+            .WithConfigFileWatching();
+
+    QCOMPARE( Payload( "@" + policy ), cli["policy"].value<Payload>() );
+    QVERIFY( Payload( "@" + policy ) != Payload( "deny everyone\n" ) );
+
+    writeFile( path, ( "policy=@" + policy + "\nmode=slow\n" ).toUtf8() );
+    QCOMPARE( cli.reloadConfiguration(), QStringList({"mode"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testAliasFindsArgument()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--quiet"})
+            .WithFlag("silent", "Print nothing.")
+            .WithAlias("quiet", "silent");
+
+    QCOMPARE( cli["silent"].toBool(), true );
+    QCOMPARE( cli["quiet"].toBool(), true );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testAliasCollisionThrows()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {});
+    builder.WithFlag("force", "Will force a refresh.")
+           .WithFlag("debug", "Print debug messages.");
+
+    QVERIFY_EXCEPTION_THROWN( builder.WithAlias("debug", "force"), ArgumentRedefinitionException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testDeprecatedNameRedirects()
+{
+    QTest::ignoreMessage( QtWarningMsg, "The argument threads is deprecated, use workers instead" );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--threads", "8"})
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithDeprecated("threads", "workers");
+
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("8") );
+    QVERIFY( cli.m_reportedDeprecations.contains( "threads" ) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPresetExpands()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--prod"})
+            .WithValue("log-level", "info", "How much to log.")
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithPreset("prod", {"--log-level=warn", "--workers", "64"});
+
+    QCOMPARE( cli["log-level"].toString(), QStringLiteral("warn") );
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("64") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPresetOverriddenByLaterOption()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--prod", "--workers=8"})
+            .WithValue("log-level", "info", "How much to log.")
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithPreset("prod", {"--log-level=warn", "--workers", "64"});
+
+    QCOMPARE( cli["log-level"].toString(), QStringLiteral("warn") );
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("8") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPresetDoesNotClaimNextInput()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--prod", "input.txt"})
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithPreset("prod", {"--workers=64"});
+
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("64") );
+    QCOMPARE( cli.positionalArguments().count(), 1 );
+    QCOMPARE( cli.positionalArguments().at(0), QStringLiteral("input.txt") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPresetNamingPreset()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--prod-debug"})
+            .WithValue("log-level", "info", "How much to log.")
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithPreset("prod", {"--log-level=warn", "--workers=64"})
+            .WithPreset("prod-debug", {"--prod", "--log-level", "debug"});
+
+    QCOMPARE( cli["log-level"].toString(), QStringLiteral("debug") );
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("64") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testPresetNameCollisionThrows()
+{
+    CommandLineInterfaceBuilder builder("My Cool App", {});
+    builder.WithValue("workers", "4", "How many workers to start.");
+
+    QVERIFY_EXCEPTION_THROWN( builder.WithPreset("workers", {"--workers=64"}), ArgumentRedefinitionException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationOfArgument()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--data-dir=/tmp"})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.")
+            .WithInterpolation();
+
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("/tmp/logs") );
+    QCOMPARE( cli["data-dir"].toString(), QStringLiteral("/tmp") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationOfEnvironmentVariable()
+{
+    qputenv( "TARANIS_TEST_ROOT", "/srv" );
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--data-dir=${TARANIS_TEST_ROOT}/app"})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithInterpolation();
+
+    QCOMPARE( cli["data-dir"].toString(), QStringLiteral("/srv/app") );
+    qunsetenv( "TARANIS_TEST_ROOT" );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationEscapedPlaceholder()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--log-dir=$${data-dir}/logs"})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("log-dir", "Where to write logs.")
+            .WithInterpolation();
+
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("${data-dir}/logs") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationIsOptIn()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.");
+
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("${data-dir}/logs") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationCycleThrows()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("data-dir", "${log-dir}/..", "Where to keep data.")
+            .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.")
+            .WithInterpolation();
+
+    QVERIFY_EXCEPTION_THROWN( cli["log-dir"], InterpolationCycleException );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationFollowsValueChanges()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("log-dir", "${data-dir}/logs", "Where to write logs.")
+            .WithInterpolation();
+
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("/var/lib/app/logs") );
+    cli.setValue( "data-dir", "/opt/app" );
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("/opt/app/logs") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationThroughSubtree()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--data-dir=/tmp"})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("db.path", "${data-dir}/db", "Where to keep the database.")
+            .WithValue("db.journal", "${db.path}/journal", "Where to keep the journal.")
+            .WithInterpolation();
+
+    ArgumentSubtree db = cli.subtree("db");
+    QCOMPARE( db.value("path").toString(), QStringLiteral("/tmp/db") );
+    QCOMPARE( db["journal"].toString(), QStringLiteral("/tmp/db/journal") );
+
+    QStringList values;
+    for ( ArgumentSubtree::const_iterator it = db.begin(); it != db.end(); ++it )
+    {
+        values.append( it.value().toString() );
+    }
+    QCOMPARE( values, QStringList({"/tmp/db/journal", "/tmp/db"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testInterpolationOfBoundVariable()
+{
+    QString logDir;
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--data-dir=/tmp", "--log-dir=${data-dir}/logs"})
+            .WithValue("data-dir", "/var/lib/app", "Where to keep data.")
+            .WithValue("log-dir", "Where to write logs.", &logDir)
+            .WithInterpolation();
+
+    QCOMPARE( logDir, QStringLiteral("/tmp/logs") );
+    QCOMPARE( cli["log-dir"].toString(), QStringLiteral("/tmp/logs") );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCanonicalArgumentsOnlyChangedValues()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"-f", "--workers:64", "--log-level", "info", "input.txt"})
+            .WithFlag("force", "Will force a refresh.")
+            .WithValue("workers", "4", "How many workers to start.")
+            .WithValue("log-level", "info", "How much to log.");
+
+    QCOMPARE( cli.canonicalArguments(), QStringList({"--force", "--workers=64", "input.txt"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCanonicalArgumentsChoiceAndEndOfOptions()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--mode", "FAST", "--", "-x"})
+            .WithChoice("mode", {"fast", "safe"}, "safe", "How to run.");
+
+    QCOMPARE( cli.canonicalArguments(), QStringList({"--mode=fast", "--", "-x"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testCanonicalArgumentsEmptyValueRoundTrip()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--prefix", "", "--force", "input.txt"})
+            .WithFlag("force", "Will force a refresh.")
+            .WithValue("prefix", "/usr/local", "Where to install.");
+
+    QCOMPARE( cli["prefix"].toString(), QString("") );
+    QCOMPARE( cli.canonicalArguments(), QStringList({"--force", "--prefix", "", "input.txt"}) );
+
+    CommandLineInterface copy = CommandLineInterfaceBuilder("My Cool App", cli.canonicalArguments())
+            .WithFlag("force", "Will force a refresh.")
+            .WithValue("prefix", "/usr/local", "Where to install.");
+
+    QCOMPARE( copy["prefix"].toString(), QString("") );
+    QCOMPARE( copy["force"].toBool(), true );
+    QCOMPARE( copy.positionalArguments().toStringList(), QStringList({"input.txt"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSerializedValuesRoundTrip()
+{
+    CommandLineInterface parent = CommandLineInterfaceBuilder("My Cool App", {"build", "--workers=64", "--force", "a.txt"})
+            .WithCommand("build", "Build it.", [](CommandLineInterfaceBuilder& builder) {
+                builder.WithFlag("force", "Will force a refresh.");
+            })
+            .WithValue("workers", "4", "How many workers to start.");
+
+    CommandLineInterface child = CommandLineInterfaceBuilder("My Cool App", {"--workers=2"})
+            .WithSerializedValues( parent.serializedValues() )
+            .WithCommand("build", "Build it.", [](CommandLineInterfaceBuilder& builder) {
+                builder.WithFlag("force", "Will force a refresh.");
+            })
+            .WithValue("workers", "4", "How many workers to start.");
+
+    QCOMPARE( child.command(), QStringLiteral("build") );
+    QCOMPARE( child["workers"].toString(), QStringLiteral("64") );
+    QCOMPARE( child["force"].toBool(), true );
+    QCOMPARE( child.positionalArguments().toStringList(), QStringList({"a.txt"}) );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TaranisTestSuite::testSerializedValuesIgnoredWhenInvalid()
+{
+    CommandLineInterface cli = CommandLineInterfaceBuilder("My Cool App", {"--workers=2"})
+            .WithSerializedValues( QByteArray("not serialized values") )
+            .WithValue("workers", "4", "How many workers to start.");
+
+    QCOMPARE( cli["workers"].toString(), QStringLiteral("2") );
+}
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 void TaranisTestSuite::testIsValidWhenItIs()
@@ -29,6 +29,8 @@
 
 namespace Taranis
 {
+    class CommandLineInterfaceBuilder;
+
     namespace UnitTest
     {
         class TaranisTestSuite : public QObject
@@ -146,6 +148,208 @@ namespace Taranis
             void testFlagWithValueAndCustomHandler();
             void testActionWithValue();
 
+            /// Configuration Files and Environment
+            void testValueFromIniConfigFile();
+            void testValueFromIniConfigFileSection();
+            void testValueFromJsonConfigFile();
+            void testLargeNumberFromJsonConfigFile();
+            void testFlagFromConfigFile();
+            void testConfigFileOverriddenByCommandLine();
+            void testConfigFileOverriddenByEnvironment();
+            void testLaterConfigFileOverridesEarlierOne();
+            void testMissingConfigFileIsIgnored();
+
+            /// Configuration Reloading
+            void testReloadConfigurationAppliesChangedValues();
+            void testReloadConfigurationOnlyExecutesChangedActions();
+            void testReloadConfigurationKeepsCommandLineValues();
+            void testReloadConfigurationRevertsRemovedValuesToDefault();
+            void testReloadConfigurationRejectsInvalidValues();
+            void testReloadConfigurationRejectsInvalidChoice();
+            void testReloadConfigurationWithoutWatchingDoesNothing();
+
+            /// Value Snapshots
+            void testSetValueChangesValue();
+            void testSetValueIsSharedBetweenCopies();
+            void testConcurrentReadsWhileSettingValues();
+            void testConcurrentReadsOfBoundValue();
+
+            /// Commands
+            void testCommandSelected();
+            void testCommandNotSelected();
+            void testCommandAfterGlobalOption();
+            void testCommandAfterGlobalOptionValue();
+            void testCommandCaseInsensative();
+            void testNestedCommand();
+            void testHelpMessageWithCommands();
+            void testHelpMessageForSelectedCommand();
+
+            /// Positional Arguments
+            void testPositionalArguments();
+            void testFlagDoesNotConsumePositionalArgument();
+            void testEndOfOptionsMarker();
+            void testPositionalListWithTrailingPositional();
+            void testMissingPositionalArgument();
+            void testPositionalSpanDoesNotCopyInputs();
+            void testLargePositionalList();
+            void testDefiningTwoPositionalListsThrows();
+            void testHelpMessageWithPositionalArguments();
+
+            /// Bound Values
+            void testFlagBoundToVariable();
+            void testValueBoundToInt();
+            void testValueBoundToIntWithInvalidInput();
+            void testValueBoundToDoubleAndString();
+            void testValueBoundToProperty();
+            void testBoundValueFromConfigFile();
+
+            /// Deferred Actions
+            void testDeferredActionsRunInPriorityOrder();
+            void testDeferredActionsWithEqualPriorityKeepTheirOrder();
+            void testPriorityIgnoredWhenActionsAreNotDeferred();
+            void testDeferredActionsRunAfterValuesAreStored();
+
+            /// Asynchronous Actions
+            void testDeferredActionsWaitForTheirDependencies();
+            void testCircularDependencyThrows();
+            void testAsyncActionsRunConcurrently();
+            void testAsyncActionsWaitForTheirDependencies();
+            void testActionsFinishedWhenNotAsync();
+            void testFailingAsyncActionStillFinishes();
+            void testVersionActionRunsOnCallingThread();
+
+            /// Statistics
+            void testStatisticsRecordedWhenEnabled();
+            void testStatisticsEmptyWhenNotEnabled();
+            void testStatisticsArgumentIsHidden();
+            void testHelpRenderingIsRecorded();
+            void testStatisticsAsJson();
+            void testStatisticsChromeTrace();
+
+            /// Allocation Budgets
+            void testSchemaConstructionAllocationBudget();
+            void testTokenizationAllocationBudget();
+            void testPositionalTokenizationAllocationBudget();
+            void testLookupAllocationBudget();
+            void testHelpRenderingAllocationBudget();
+
+            /// Worst-Case Inputs
+            void testMegabyteTokenParsesInLinearTime();
+            void testMegabyteNameParsesInLinearTime();
+            void testMillionSeperatorsParseInLinearTime();
+            void testMillionTinyTokensParseInLinearTime();
+            void testPlaceholdersInInputAreNotExpanded();
+
+            /// Lazy Parsing
+            void testLazyParsingDefersProcessing();
+            void testLazyParsingProcessesOnlyOnce();
+            void testLazyParsingSharedByCopies();
+            void testLazyParsingOfPositionalArguments();
+            void testLazyParsingRunsActionsStraightAway();
+            void testLazyParsingWritesBoundValuesStraightAway();
+            void testLazyParsingChecksRulesStraightAway();
+
+            /// Early Exit
+            void testVersionOnlyRequestSkipsRegistration();
+            void testVersionShortNameOnlyRequestSkipsRegistration();
+            void testVersionWithOtherInputsRegistersEverything();
+            void testCustomVersionActionRegistersEverything();
+            void testHelpMessageIsRenderedOnce();
+
+            /// Schema Cache
+            void testSchemaCacheIsUsedOnTheNextBuild();
+            void testSchemaCacheIsRebuiltWhenManifestChanges();
+            void testSchemaCacheNotWrittenForCallbacks();
+            void testSchemaCacheNotWrittenForRules();
+            void testSchemaCacheCollisionFallsBackToRegistration();
+            void testSchemaCacheNotWrittenForAliasOfExistingArgument();
+            void testDamagedSchemaCacheIsIgnored();
+
+            /// Namespaces
+            void testNamespaceLoadedForInputUnderIt();
+            void testNamespaceNotLoadedWhenUnused();
+            void testNamespaceLoadedWhenValueRead();
+            void testNestedNamespacesLoadOuterFirst();
+            void testHelpLoadsEveryNamespace();
+            void testDottedNamesHaveNoShortName();
+
+            /// Subtree
+            void testSubtreeContainsOnlyArgumentsUnderPath();
+            void testSubtreeLooksUpRelativeNames();
+            void testNestedSubtree();
+            void testSubtreeOfUnknownPathIsEmpty();
+            void testSubtreeLoadsNamespacesUnderPath();
+            void testSubtreeIteratesInNameOrder();
+
+            /// Completion
+            void testCompletesOptionNames();
+            void testCompletesValuesFromProvider();
+            void testCompletesCommands();
+            void testCompletionSkipsProcessing();
+            void testCompletionLoadsOnlyMatchingNamespaces();
+            void testCompletionScripts();
+
+            /// Choices
+            void testChoiceStoresOrdinal();
+            void testChoiceDefault();
+            void testInvalidChoiceThrows();
+            void testChoiceTableFindsEveryChoice();
+            void testHelpListsChoices();
+
+            /// Constraints
+            void testMissingRequiredArgumentThrows();
+            void testConstraintsSatisfied();
+            void testEveryViolationIsReported();
+            void testViolationsStopCallbacks();
+            void testHelpSkipsConstraints();
+            void testRejectedCommandLineLeavesStoreUsable();
+            void testRejectedCommandLineLeavesBoundStorageAlone();
+            void testConfigurationValueSatisfiesRequired();
+
+            /// Validators
+            void testRangeValidator();
+            void testPatternMatchesWholeValue();
+            void testHostPortValidator();
+            void testFileChecksAreBatchedAndAggregated();
+            void testBoundValueValidatedBeforeWrite();
+
+            /// Payloads
+            void testPayloadInlineValue();
+            void testPayloadEscapedAtSign();
+            void testPayloadFromFile();
+            void testPayloadFromMissingFile();
+            void testPayloadTooLargeForData();
+            void testPayloadFromStandardInput();
+            void testPayloadIsNotReadUntilAccessed();
+            void testPayloadUnchangedByReload();
+
+            /// Aliases and Presets
+            void testAliasFindsArgument();
+            void testAliasCollisionThrows();
+            void testDeprecatedNameRedirects();
+            void testPresetExpands();
+            void testPresetOverriddenByLaterOption();
+            void testPresetDoesNotClaimNextInput();
+            void testPresetNamingPreset();
+            void testPresetNameCollisionThrows();
+
+            /// Interpolation
+            void testInterpolationOfArgument();
+            void testInterpolationOfEnvironmentVariable();
+            void testInterpolationEscapedPlaceholder();
+            void testInterpolationIsOptIn();
+            void testInterpolationCycleThrows();
+            void testInterpolationFollowsValueChanges();
+            void testInterpolationThroughSubtree();
+            void testInterpolationOfBoundVariable();
+
+            /// Serialization
+            void testCanonicalArgumentsOnlyChangedValues();
+            void testCanonicalArgumentsChoiceAndEndOfOptions();
+            void testCanonicalArgumentsEmptyValueRoundTrip();
+            void testSerializedValuesRoundTrip();
+            void testSerializedValuesIgnoredWhenInvalid();
+
             /////////////////////////////////////////////////////////////////////////////
             /// InputArgument
             void testIsValidWhenItIs();
@@ -175,6 +379,10 @@ namespace Taranis
             void testArgumentValueWhenColonSeperatorAndEqualsInValueNoSpacesUsed();
             void testArgumentValueWhenEqualsSeperatorAndColonInValueNoSpacesUsed();
 
+
+        private:
+            QString writeFile(const QString& path, const QByteArray& contents) const;
+            CommandLineInterfaceBuilder& addRepresentativeSchema(CommandLineInterfaceBuilder& builder) const;
         };
     }
 }